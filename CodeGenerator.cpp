@@ -0,0 +1,161 @@
+#include "CodeGenerator.hpp"
+#include <queue>
+#include <limits>
+#include <iomanip>
+using namespace std;
+
+// emits the source text of an activation function, mirroring utility.cpp
+static string activationSource(string identifier) {
+    if (identifier == "ReLU") {
+        return "    static inline double ReLU(double x) { return (x >= 0) ? x : 0.0; }\n";
+    } else if (identifier == "sigmoid") {
+        return "    static inline double sigmoid(double x) { return (1 / (1 + std::exp(-1 * x))); }\n";
+    }
+    return "    static inline double identity(double x) { return x; }\n";
+}
+
+void generateScorer(NeuralNetwork& nn, ostream& out, string nameSpace) {
+    vector<vector<int> > layers = nn.getLayers();
+    vector<int> inputNodeIds = nn.getInputNodeIds();
+    vector<int> outputNodeIds = nn.getOutputNodeIds();
+    AdjList& adjacencyList = nn.getAdjacencyList();
+    int numNodes = adjacencyList.size();
+
+    // locate every node by (layer, index within layer) so weights can live in per-layer arrays
+    vector<int> layerOf(numNodes, -1);
+    vector<int> indexOf(numNodes, -1);
+    for (int l = 0; l < layers.size(); l++) {
+        for (int j = 0; j < layers.at(l).size(); j++) {
+            layerOf[layers[l][j]] = l;
+            indexOf[layers[l][j]] = j;
+        }
+    }
+
+    string guard;
+    for (char c : nameSpace) {
+        guard += toupper(c);
+    }
+
+    out << setprecision(numeric_limits<double>::max_digits10);
+
+    out << "// Generated by codegen. Do not edit." << endl;
+    out << "#ifndef " << guard << "_SCORER_HPP" << endl;
+    out << "#define " << guard << "_SCORER_HPP" << endl << endl;
+    out << "#include <array>" << endl;
+    out << "#include <cmath>" << endl << endl;
+    out << "namespace " << nameSpace << " {" << endl << endl;
+
+    string shape;
+    for (int l = 0; l < layers.size(); l++) {
+        shape += (l ? ", " : "") + to_string(layers.at(l).size());
+    }
+
+    out << "template <int... LayerSizes>" << endl;
+    out << "struct Model;" << endl << endl;
+    out << "template <>" << endl;
+    out << "struct Model<" << shape << "> {" << endl;
+
+    set<string> activations;
+    for (int id = 0; id < numNodes; id++) {
+        activations.insert(getActivationIdentifier(nn.getNode(id)->activationFunction));
+    }
+    for (auto a : activations) {
+        out << activationSource(a);
+    }
+    out << endl;
+
+    // weights are stored as W<l>[dest][source] for the connections entering layer l
+    for (int l = 0; l < layers.size(); l++) {
+        out << "    static constexpr double B" << l << "[" << layers[l].size() << "] = {";
+        for (int j = 0; j < layers[l].size(); j++) {
+            out << (j ? ", " : "") << nn.getNode(layers[l][j])->bias;
+        }
+        out << "};" << endl;
+
+        if (l == 0) continue;
+        out << "    static constexpr double W" << l << "[" << layers[l].size() << "][" << layers[l-1].size() << "] = {" << endl;
+        for (int j = 0; j < layers[l].size(); j++) {
+            out << "        {";
+            for (int i = 0; i < layers[l-1].size(); i++) {
+                auto edge = adjacencyList[layers[l-1][i]].find(layers[l][j]);
+                double w = (edge == adjacencyList[layers[l-1][i]].end()) ? 0.0 : edge->second.weight;
+                out << (i ? ", " : "") << w;
+            }
+            out << "}," << endl;
+        }
+        out << "    };" << endl;
+    }
+    out << endl;
+
+    // replay the breadth first traversal of NeuralNetwork::predict, emitting each
+    // accumulation as a straight-line statement in the same order
+    stringstream body;
+    vector<bool> visited(numNodes, false);
+    queue<int> nodeQueue;
+
+    for (int i = 0; i < inputNodeIds.size(); i++) {
+        body << "        double z" << inputNodeIds[i] << " = x[" << i << "];" << endl;
+        nodeQueue.push(inputNodeIds[i]);
+        visited[inputNodeIds[i]] = true;
+    }
+    for (int id = 0; id < numNodes; id++) {
+        if (!visited[id]) {
+            body << "        double z" << id << " = 0.0;" << endl;
+        }
+    }
+
+    vector<bool> activated(numNodes, false);
+    while (!nodeQueue.empty()) {
+        int curr = nodeQueue.front();
+        nodeQueue.pop();
+
+        string act = getActivationIdentifier(nn.getNode(curr)->activationFunction);
+        body << "        z" << curr << " += B" << layerOf[curr] << "[" << indexOf[curr] << "];" << endl;
+        body << "        const double a" << curr << " = " << act << "(z" << curr << ");" << endl;
+        activated[curr] = true;
+
+        for (auto edge : adjacencyList[curr]) {
+            int dest = edge.first;
+            body << "        z" << dest << " += a" << curr << " * W" << layerOf[dest]
+                 << "[" << indexOf[dest] << "][" << indexOf[curr] << "];" << endl;
+            if (!visited[dest]) {
+                visited[dest] = true;
+                nodeQueue.push(dest);
+            }
+        }
+    }
+
+    body << "        return {";
+    for (int i = 0; i < outputNodeIds.size(); i++) {
+        int id = outputNodeIds[i];
+        body << (i ? ", " : "") << (activated[id] ? "a" + to_string(id) : "0.0");
+    }
+    body << "};" << endl;
+
+    out << "    static inline std::array<double, " << outputNodeIds.size() << "> "
+        << "predict(const std::array<double, " << inputNodeIds.size() << ">& x) {" << endl;
+    out << body.str();
+    out << "    }" << endl;
+    out << "};" << endl << endl;
+
+    out << "using Scorer = Model<" << shape << ">;" << endl << endl;
+    out << "inline std::array<double, " << outputNodeIds.size() << "> "
+        << "predict(const std::array<double, " << inputNodeIds.size() << ">& x) {" << endl;
+    out << "    return Scorer::predict(x);" << endl;
+    out << "}" << endl << endl;
+    out << "}" << endl << endl;
+    out << "#endif" << endl;
+}
+
+void generateScorer(string modelFile, string headerFile, string nameSpace) {
+    NeuralNetwork nn(modelFile);
+    ofstream fout(headerFile);
+
+    if (fout.fail()) {
+        cerr << "Could not open " << headerFile << " for writing. " << endl;
+        exit(1);
+    }
+
+    generateScorer(nn, fout, nameSpace);
+    fout.close();
+}
@@ -0,0 +1,15 @@
+#ifndef CODE_GENERATOR_HPP
+#define CODE_GENERATOR_HPP
+
+#include "NeuralNetwork.hpp"
+#include <string>
+#include <iostream>
+
+// Emits a self-contained C++ header that scores inputs with a fixed, trained model.
+// The weights become constexpr arrays and predict is fully unrolled in exactly the
+// order NeuralNetwork::predict accumulates, so both produce bit-identical outputs.
+// The emitted header only depends on <array> and <cmath>.
+void generateScorer(NeuralNetwork& nn, std::ostream& out, std::string nameSpace);
+void generateScorer(std::string modelFile, std::string headerFile, std::string nameSpace);
+
+#endif
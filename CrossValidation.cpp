@@ -0,0 +1,144 @@
+#include "CrossValidation.hpp"
+#include <algorithm>
+#include <random>
+#include <map>
+using namespace std;
+
+// DatasetView -----------------------------------------------------------------------------------------------------------------------------------
+
+DatasetView::DatasetView(const vector<DataInstance>& data, vector<int> indices) {
+    this->data = &data;
+    this->indices = indices;
+}
+
+size_t DatasetView::size() const {
+    return indices.size();
+}
+
+const DataInstance& DatasetView::at(size_t i) const {
+    return data->at(indices.at(i));
+}
+
+// Fold -----------------------------------------------------------------------------------------------------------------------------------
+
+Fold::Fold(DatasetView train, DatasetView test) : train(train), test(test) {}
+
+// builds the folds given the fold each instance is assigned to
+static vector<Fold> makeFolds(const vector<DataInstance>& data, const vector<int>& foldOf, int k) {
+    vector<vector<int> > members(k);
+    for (int i = 0; i < foldOf.size(); i++) {
+        members[foldOf[i]].push_back(i);
+    }
+
+    vector<Fold> folds;
+    for (int f = 0; f < k; f++) {
+        vector<int> train;
+        for (int g = 0; g < k; g++) {
+            if (g != f) {
+                train.insert(train.end(), members[g].begin(), members[g].end());
+            }
+        }
+        sort(train.begin(), train.end());
+        folds.push_back(Fold(DatasetView(data, train), DatasetView(data, members[f])));
+    }
+    return folds;
+}
+
+vector<Fold> kFold(const vector<DataInstance>& data, int k, unsigned int seed) {
+    if (k < 2 || k > data.size()) {
+        cerr << "k-fold cross validation needs 2 <= k <= " << data.size() << ", but got k = " << k << endl;
+        exit(1);
+    }
+
+    vector<int> order(data.size());
+    for (int i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    mt19937 gen(seed);
+    shuffle(order.begin(), order.end(), gen);
+
+    vector<int> foldOf(data.size());
+    for (int i = 0; i < order.size(); i++) {
+        foldOf[order[i]] = i % k;
+    }
+    return makeFolds(data, foldOf, k);
+}
+
+vector<Fold> stratifiedKFold(const vector<DataInstance>& data, int k, unsigned int seed) {
+    if (k < 2 || k > data.size()) {
+        cerr << "k-fold cross validation needs 2 <= k <= " << data.size() << ", but got k = " << k << endl;
+        exit(1);
+    }
+
+    map<int, vector<int> > byLabel;
+    for (int i = 0; i < data.size(); i++) {
+        byLabel[data[i].y].push_back(i);
+    }
+
+    // deal every label's shuffled instances round robin, continuing where the previous label stopped
+    mt19937 gen(seed);
+    vector<int> foldOf(data.size());
+    int next = 0;
+    for (auto& label : byLabel) {
+        shuffle(label.second.begin(), label.second.end(), gen);
+        for (int i = 0; i < label.second.size(); i++) {
+            foldOf[label.second[i]] = next++ % k;
+        }
+    }
+    return makeFolds(data, foldOf, k);
+}
+
+// writes the standardized features of raw into scratch
+static void standardize(const DataInstance& raw, const vector<double>& mean, const vector<double>& stdDev, DataInstance& scratch) {
+    for (size_t i = 0; i < raw.x.size(); i++) {
+        scratch.x[i] = (stdDev[i] > 0) ? (raw.x[i] - mean[i]) / stdDev[i] : 0;
+    }
+    scratch.y = raw.y;
+}
+
+CrossValidationResult crossValidate(const NeuralNetwork& nn, const vector<Fold>& folds, int numEpochs, ThreadPool& pool) {
+    CrossValidationResult result;
+    result.foldAccuracies.resize(folds.size());
+
+    pool.parallelFor(0, folds.size(), [&](int f) {
+        const Fold& fold = folds[f];
+        NeuralNetwork model(nn);
+
+        vector<double> mean = calculateMean(*fold.train.data, fold.train.indices);
+        vector<double> stdDev = calculateStdDev(*fold.train.data, fold.train.indices, mean);
+        DataInstance scratch(vector<double>(mean.size()));
+
+        model.train();
+        for (int i = 0; i < numEpochs; i++) {
+            for (size_t j = 0; j < fold.train.size(); j++) {
+                standardize(fold.train.at(j), mean, stdDev, scratch);
+                model.predict(scratch);
+            }
+            model.update();
+        }
+
+        model.eval();
+        double correct = 0;
+        for (size_t j = 0; j < fold.test.size(); j++) {
+            standardize(fold.test.at(j), mean, stdDev, scratch);
+            vector<double> output = model.predict(scratch);
+            if (static_cast<int>(round(output.at(0))) == scratch.y) {
+                correct++;
+            }
+        }
+        result.foldAccuracies[f] = fold.test.size() ? correct / fold.test.size() : 0;
+    });
+
+    result.mean = 0;
+    for (double accuracy : result.foldAccuracies) {
+        result.mean += accuracy;
+    }
+    result.mean /= folds.size();
+
+    result.stdDev = 0;
+    for (double accuracy : result.foldAccuracies) {
+        result.stdDev += pow(accuracy - result.mean, 2);
+    }
+    result.stdDev = sqrt(result.stdDev / folds.size());
+    return result;
+}
@@ -0,0 +1,42 @@
+#ifndef CROSS_VALIDATION_HPP
+#define CROSS_VALIDATION_HPP
+
+#include "NeuralNetwork.hpp"
+#include "ThreadPool.hpp"
+
+// DatasetView selects instances of a loaded dataset by index, without copying them
+struct DatasetView {
+    DatasetView(const std::vector<DataInstance>& data, std::vector<int> indices);
+
+    size_t size() const;
+    const DataInstance& at(size_t i) const;
+
+    const std::vector<DataInstance>* data;
+    std::vector<int> indices;
+};
+
+// Fold is one train/test split of a cross validation, as views over the same dataset
+struct Fold {
+    Fold(DatasetView train, DatasetView test);
+    DatasetView train;
+    DatasetView test;
+};
+
+// splits data into k folds of shuffled indices
+std::vector<Fold> kFold(const std::vector<DataInstance>& data, int k, unsigned int seed = 1);
+// splits data into k folds that each keep the label proportions of the whole dataset
+std::vector<Fold> stratifiedKFold(const std::vector<DataInstance>& data, int k, unsigned int seed = 1);
+
+// CrossValidationResult aggregates the test accuracy of every fold
+struct CrossValidationResult {
+    std::vector<double> foldAccuracies;
+    double mean;
+    double stdDev;
+};
+
+// trains a copy of nn on every fold in parallel and assesses it on the fold's test view.
+// data must not be normalized: each fold standardizes with the statistics of its own
+// training view, computed and applied on the fly so no instance is copied
+CrossValidationResult crossValidate(const NeuralNetwork& nn, const std::vector<Fold>& folds, int numEpochs, ThreadPool& pool);
+
+#endif
@@ -31,9 +31,49 @@ std::vector<double> calculateStdDev(const std::vector<DataInstance>& data, const
     return std_dev;
 }
 
+std::vector<double> calculateMean(const std::vector<DataInstance>& data, const std::vector<int>& indices) {
+    if (indices.empty()) return {};
+
+    std::vector<double> mean(data[indices[0]].x.size(), 0.0);
+    for (int index : indices) {
+        const DataInstance& instance = data[index];
+        for (size_t i = 0; i < instance.x.size(); ++i) {
+            mean[i] += instance.x[i];
+        }
+    }
+    for (double& m : mean) {
+        m /= indices.size();
+    }
+    return mean;
+}
+
+std::vector<double> calculateStdDev(const std::vector<DataInstance>& data, const std::vector<int>& indices, const std::vector<double>& mean) {
+    if (indices.empty()) return {};
+
+    std::vector<double> std_dev(mean.size(), 0.0);
+    for (int index : indices) {
+        const DataInstance& instance = data[index];
+        for (size_t i = 0; i < instance.x.size(); ++i) {
+            std_dev[i] += std::pow(instance.x[i] - mean[i], 2);
+        }
+    }
+    for (double& sd : std_dev) {
+        sd = std::sqrt(sd / indices.size());
+    }
+    return std_dev;
+}
+
 DataInstance::DataInstance(vector<double> features, int label) {
     x = features;
     y = label;
+    sparse = false;
+}
+
+DataInstance::DataInstance(vector<int> indices, vector<double> values, int label) {
+    this->indices = indices;
+    this->values = values;
+    y = label;
+    sparse = true;
 }
 
 ostream& operator<<(ostream& o, const DataInstance& d) {
@@ -41,11 +81,14 @@ ostream& operator<<(ostream& o, const DataInstance& d) {
     for (int i = 0; i < d.x.size(); i++) {
         o << d.x.at(i) << ", ";
     }
+    for (int i = 0; i < d.indices.size(); i++) {
+        o << d.indices.at(i) << ":" << d.values.at(i) << ", ";
+    }
     o << endl;
     return o;
 }
 
-DataLoader::DataLoader(string filename) {
+DataLoader::DataLoader(string filename, bool normalize) {
     ifstream fin(filename);
 
     if (fin.fail()) {
@@ -53,12 +96,12 @@ DataLoader::DataLoader(string filename) {
         exit(1);
     }
 
-    loadData(fin);
+    loadData(fin, normalize);
     fin.close();
 }
 
-DataLoader::DataLoader(istream& in) {
-    loadData(in);
+DataLoader::DataLoader(istream& in, bool normalize) {
+    loadData(in, normalize);
 }
 
 std::vector<std::string> DataLoader::split(string s, string delimiter) {
@@ -76,16 +119,31 @@ std::vector<std::string> DataLoader::split(string s, string delimiter) {
     return res;
 }
 
-void DataLoader::loadData(istream& in) {
+void DataLoader::loadData(istream& in, bool normalize) {
 
+    // the format is decided once for the whole file: a label-only line is a valid sparse
+    // instance with no non-zero features, so it cannot tell the formats apart by itself
+    std::vector<std::string> lines;
     std::string line;
+    sparse = false;
     while (getline(in, line)) {
+        sparse = sparse || line.find(':') != string::npos;
+        lines.push_back(line);
+    }
+
+    for (size_t l = 0; l < lines.size(); l++) {
+        if (sparse) {
+            if (lines[l].find_first_not_of(" \t\r") != string::npos) {
+                data.push_back(parseSparse(lines[l]));
+            }
+            continue;
+        }
 
         std::vector<double> features;
         std::vector<string> tokens;
         int label;
 
-        tokens = split(line, ",");
+        tokens = split(lines[l], ",");
         for (int i = 0; i < tokens.size()-1; i++) {
             features.push_back(stod(tokens.at(i)));
         }
@@ -94,15 +152,47 @@ void DataLoader::loadData(istream& in) {
         data.push_back(DataInstance(features, label));
     }
 
-    normalizeDataSet();
+    if (normalize) {
+        normalizeDataSet();
+    }
 }
 
-vector<DataInstance> DataLoader::getData() const {
+DataInstance DataLoader::parseSparse(string line) {
+    std::vector<int> indices;
+    std::vector<double> values;
+    std::stringstream tokens(line);
+    std::string token;
+    int label;
+
+    tokens >> label;
+    while (tokens >> token) {
+        size_t colon = token.find(':');
+        int index = stoi(token.substr(0, colon));
+        double value = stod(token.substr(colon + 1));
+        if (index < 1) {
+            cerr << "Sparse feature indices start at 1, but got " << index << endl;
+            exit(1);
+        }
+
+        // libsvm numbers features from 1, nodes are numbered from 0
+        if (value != 0) {
+            indices.push_back(index - 1);
+            values.push_back(value);
+        }
+    }
+    return DataInstance(indices, values, label);
+}
+
+const vector<DataInstance>& DataLoader::getData() const {
     return data;
 }
 
+bool DataLoader::isSparse() const {
+    return sparse;
+}
+
 void DataLoader::normalizeDataSet() {
-    if (data.empty()) return;
+    if (data.empty() || sparse) return;
 
     std::vector<double> mean = calculateMean(data);
     std::vector<double> std_dev = calculateStdDev(data, mean);
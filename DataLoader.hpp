@@ -10,9 +10,15 @@
 #include <cmath>
 
 // DataInstance class stores an instance of data
+// Dense instances keep every feature in x. Sparse instances leave x empty and only
+// keep the non-zero features as (indices, values) pairs.
 struct DataInstance {
     DataInstance(std::vector<double> features, int label = 0);
+    DataInstance(std::vector<int> indices, std::vector<double> values, int label = 0);
     std::vector<double> x;
+    std::vector<int> indices;
+    std::vector<double> values;
+    bool sparse;
     int y;
 
     friend std::ostream& operator<<(std::ostream& o, const DataInstance& d);
@@ -22,19 +28,33 @@ struct DataInstance {
 std::vector<double> calculateMean(const std::vector<DataInstance>& data);
 std::vector<double> calculateStdDev(const std::vector<DataInstance>& data, const std::vector<double>& mean);
 
+// Same as above, restricted to the instances at the given indices
+std::vector<double> calculateMean(const std::vector<DataInstance>& data, const std::vector<int>& indices);
+std::vector<double> calculateStdDev(const std::vector<DataInstance>& data, const std::vector<int>& indices, const std::vector<double>& mean);
+
 // DataLoader class loads data and stores the data as DataInstances
+// Lines are either comma separated features followed by the label, or sparse libsvm
+// "label index:value index:value ..." lines listing only non-zero features, with the
+// first feature at index 1. Sparse instances store 0-based indices. A file is sparse as
+// soon as any line contains ':', and then every line is parsed as sparse, so a line
+// holding only a label is an instance whose features are all zero.
+// Sparse instances are never normalized, since that would make every feature non-zero.
 class DataLoader {
     public:
-        DataLoader(std::string filename);
-        DataLoader(std::istream& fin);
+        // normalize standardizes every feature with the statistics of the loaded data
+        DataLoader(std::string filename, bool normalize = true);
+        DataLoader(std::istream& fin, bool normalize = true);
 
-        std::vector<DataInstance> getData() const;
+        const std::vector<DataInstance>& getData() const;
+        bool isSparse() const; // whether the file was read as sparse libsvm lines
 
     private:
 
         std::vector<std::string> split(std::string s, std::string delimiter);
-        void loadData(std::istream& in);
+        void loadData(std::istream& in, bool normalize);
+        DataInstance parseSparse(std::string line);
         std::vector<DataInstance> data;
+        bool sparse;
 
         void normalizeDataSet();
 
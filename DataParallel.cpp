@@ -0,0 +1,153 @@
+#include "DataParallel.hpp"
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+using namespace std;
+
+void trainWorker(NeuralNetwork& nn, const vector<DataInstance>& shard, Transport& transport, int numEpochs) {
+    nn.train();
+
+    for (int i = 0; i < numEpochs; i++) {
+        for (size_t j = 0; j < shard.size(); j++) {
+            nn.predict(shard[j]);
+        }
+
+        vector<double> gradients = nn.getGradients();
+        transport.allreduce(gradients);
+        nn.setGradients(gradients);
+        nn.update();
+    }
+}
+
+NeuralNetwork trainDataParallel(NeuralNetwork nn, const vector<DataInstance>& data, int numWorkers, int numEpochs) {
+    if (numWorkers < 1) {
+        cerr << "Data parallel training needs at least 1 worker, but got " << numWorkers << endl;
+        exit(1);
+    }
+
+    int length = nn.getGradients().size();
+    string name = "/neuralnet-" + to_string(getpid());
+    SharedMemoryTransport::create(name, numWorkers, length);
+
+    // rank 0 sends its final parameters back through this pipe
+    int fds[2];
+    if (pipe(fds) != 0) {
+        cerr << "Could not create pipe: " << strerror(errno) << endl;
+        exit(1);
+    }
+
+    // flush before forking, so buffered output is not written again by every worker
+    cout.flush();
+    cerr.flush();
+
+    vector<pid_t> workers;
+    for (int rank = 0; rank < numWorkers; rank++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            cerr << "Could not fork worker " << rank << ": " << strerror(errno) << endl;
+            for (int r = 0; r < workers.size(); r++) {
+                kill(workers[r], SIGKILL);
+                waitpid(workers[r], nullptr, 0);
+            }
+            SharedMemoryTransport::destroy(name);
+            exit(1);
+        }
+
+        if (pid == 0) {
+            close(fds[0]);
+
+            vector<DataInstance> shard;
+            for (size_t i = rank; i < data.size(); i += numWorkers) {
+                shard.push_back(data[i]);
+            }
+
+            // the worker's copy of nn was inherited through fork, so every replica starts identical
+            {
+                SharedMemoryTransport transport(name, rank, numWorkers, length);
+                trainWorker(nn, shard, transport, numEpochs);
+            }
+
+            if (rank == 0) {
+                vector<double> parameters = nn.getParameters();
+                const char* bytes = reinterpret_cast<const char*>(parameters.data());
+                size_t remaining = sizeof(double) * parameters.size();
+                while (remaining > 0) {
+                    ssize_t written = write(fds[1], bytes, remaining);
+                    if (written <= 0) _exit(1);
+                    bytes += written;
+                    remaining -= written;
+                }
+            }
+            close(fds[1]);
+            _exit(0);
+        }
+
+        workers.push_back(pid);
+    }
+    close(fds[1]);
+
+    // collect rank 0's parameters while watching the workers: one that fails leaves the others
+    // waiting at the barrier forever, so the rest are killed as soon as any worker fails
+    vector<double> parameters(length);
+    char* bytes = reinterpret_cast<char*>(parameters.data());
+    size_t remaining = sizeof(double) * parameters.size();
+    bool pipeOpen = true;
+    vector<bool> running(numWorkers, true);
+    int numRunning = numWorkers;
+    bool failed = false;
+
+    while (numRunning > 0 && !failed) {
+        // wakes up when rank 0 sends data, otherwise every 100ms to check on the workers
+        pollfd pfd = {fds[0], POLLIN, 0};
+        if (poll(&pfd, pipeOpen ? 1 : 0, 100) > 0) {
+            ssize_t received = read(fds[0], bytes, remaining);
+            if (received <= 0) {
+                pipeOpen = false;
+            } else {
+                bytes += received;
+                remaining -= received;
+            }
+        }
+
+        for (int rank = 0; rank < numWorkers; rank++) {
+            int status = 0;
+            if (running[rank] && waitpid(workers[rank], &status, WNOHANG) == workers[rank]) {
+                running[rank] = false;
+                numRunning--;
+                if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                    cerr << "Worker " << rank << " failed" << endl;
+                    failed = true;
+                }
+            }
+        }
+    }
+
+    // rank 0 may have exited before its last bytes were read
+    while (!failed && pipeOpen && remaining > 0) {
+        ssize_t received = read(fds[0], bytes, remaining);
+        if (received <= 0) break;
+        bytes += received;
+        remaining -= received;
+    }
+    close(fds[0]);
+    failed = failed || (remaining > 0);
+
+    for (int rank = 0; rank < numWorkers; rank++) {
+        if (running[rank]) {
+            kill(workers[rank], SIGKILL);
+            waitpid(workers[rank], nullptr, 0);
+        }
+    }
+    SharedMemoryTransport::destroy(name);
+
+    if (failed) {
+        cerr << "Data parallel training failed" << endl;
+        exit(1);
+    }
+
+    nn.setParameters(parameters);
+    return nn;
+}
@@ -0,0 +1,16 @@
+#ifndef DATA_PARALLEL_HPP
+#define DATA_PARALLEL_HPP
+
+#include "NeuralNetwork.hpp"
+#include "Transport.hpp"
+
+// runs one data parallel worker: every epoch it accumulates gradients over its own shard,
+// sums them with the other workers through the transport and applies the update, so all
+// replicas stay identical and match single process training on the full dataset
+void trainWorker(NeuralNetwork& nn, const std::vector<DataInstance>& shard, Transport& transport, int numEpochs);
+
+// spawns numWorkers local processes, each owning every numWorkers-th instance of data,
+// trains them over shared memory and returns the resulting network
+NeuralNetwork trainDataParallel(NeuralNetwork nn, const std::vector<DataInstance>& data, int numWorkers, int numEpochs);
+
+#endif
@@ -0,0 +1,105 @@
+#include "DenseModel.hpp"
+using namespace std;
+
+// DenseLayout -----------------------------------------------------------------------------------------------------------------------------------
+
+DenseLayout::DenseLayout() {
+    numParameters = 0;
+}
+
+DenseLayout::DenseLayout(vector<int> layerSizes, vector<string> activations) {
+    this->layerSizes = layerSizes;
+    this->activations = activations;
+
+    numParameters = 0;
+    for (int l = 0; l < layerSizes.size(); l++) {
+        activationFunctions.push_back(getActivationFunction(activations.at(l)));
+        biasOffsets.push_back(numParameters);
+        numParameters += layerSizes.at(l);
+
+        if (l == 0) {
+            weightOffsets.push_back(-1);
+        } else {
+            weightOffsets.push_back(numParameters);
+            numParameters += layerSizes.at(l) * layerSizes.at(l-1);
+        }
+    }
+}
+
+vector<double> denseForward(const DenseLayout& layout, const double* parameters, const vector<double>& input) {
+    if (input.size() != layout.layerSizes.front()) {
+        cerr << "input size mismatch." << endl;
+        cerr << "\tDenseModel expected input size: " << layout.layerSizes.front() << endl;
+        cerr << "\tBut got: " << input.size() << endl;
+        return vector<double>();
+    }
+
+    vector<double> previous(input.size());
+    const double* bias = parameters + layout.biasOffsets[0];
+    for (int i = 0; i < input.size(); i++) {
+        previous[i] = layout.activationFunctions[0](input[i] + bias[i]);
+    }
+
+    vector<double> current;
+    for (int l = 1; l < layout.layerSizes.size(); l++) {
+        int fanIn = layout.layerSizes[l-1];
+        int size = layout.layerSizes[l];
+        const double* w = parameters + layout.weightOffsets[l];
+        bias = parameters + layout.biasOffsets[l];
+        FuncSig activation = layout.activationFunctions[l];
+
+        current.assign(size, 0);
+        for (int j = 0; j < size; j++) {
+            double sum = 0;
+            for (int i = 0; i < fanIn; i++) {
+                sum += previous[i] * w[j * fanIn + i];
+            }
+            current[j] = activation(sum + bias[j]);
+        }
+        previous.swap(current);
+    }
+    return previous;
+}
+
+// DenseModel -----------------------------------------------------------------------------------------------------------------------------------
+
+DenseModel::DenseModel(const NeuralNetwork& nn) {
+    vector<vector<int> > layers = nn.getLayers();
+    const AdjList& adjacencyList = nn.getAdjacencyList();
+
+    vector<int> layerSizes;
+    vector<string> activations;
+    for (int l = 0; l < layers.size(); l++) {
+        layerSizes.push_back(layers.at(l).size());
+        activations.push_back(getActivationIdentifier(nn.getNode(layers.at(l).at(0))->activationFunction));
+    }
+    layout = DenseLayout(layerSizes, activations);
+    parameters.assign(layout.numParameters, 0);
+
+    for (int l = 0; l < layers.size(); l++) {
+        for (int j = 0; j < layers[l].size(); j++) {
+            parameters[layout.biasOffsets[l] + j] = nn.getNode(layers[l][j])->bias;
+
+            if (l == 0) continue;
+            for (int i = 0; i < layers[l-1].size(); i++) {
+                // missing connections contribute nothing, same as a zero weight
+                auto edge = adjacencyList[layers[l-1][i]].find(layers[l][j]);
+                if (edge != adjacencyList[layers[l-1][i]].end()) {
+                    parameters[layout.weightOffsets[l] + j * layers[l-1].size() + i] = edge->second.weight;
+                }
+            }
+        }
+    }
+}
+
+vector<double> DenseModel::predict(const DataInstance& instance) const {
+    return denseForward(layout, parameters.data(), instance.x);
+}
+
+const DenseLayout& DenseModel::getLayout() const {
+    return layout;
+}
+
+const vector<double>& DenseModel::getParameters() const {
+    return parameters;
+}
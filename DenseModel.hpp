@@ -0,0 +1,42 @@
+#ifndef DENSE_MODEL_HPP
+#define DENSE_MODEL_HPP
+
+#include "NeuralNetwork.hpp"
+
+// DenseLayout describes where the parameters of a layered, fully connected model live
+// in one flat array: for every layer its biases, followed for every layer but the input
+// by the weights entering it, stored as [dest][source].
+struct DenseLayout {
+    DenseLayout();
+    DenseLayout(std::vector<int> layerSizes, std::vector<std::string> activations);
+
+    std::vector<int> layerSizes;
+    std::vector<std::string> activations;
+    std::vector<FuncSig> activationFunctions;
+    std::vector<int> biasOffsets;
+    std::vector<int> weightOffsets; // -1 for the input layer
+    int numParameters;
+};
+
+// computes a dense model's output for input; the input layer adds its bias and applies
+// its activation just like NeuralNetwork::predict
+std::vector<double> denseForward(const DenseLayout& layout, const double* parameters, const std::vector<double>& input);
+
+// DenseModel is an immutable copy of a NeuralNetwork's parameters in a DenseLayout.
+// predict does not modify the model, so any number of threads can score with it at once.
+class DenseModel {
+
+    public:
+        DenseModel(const NeuralNetwork& nn);
+
+        std::vector<double> predict(const DataInstance& instance) const;
+
+        const DenseLayout& getLayout() const;
+        const std::vector<double>& getParameters() const;
+
+    private:
+        DenseLayout layout;
+        std::vector<double> parameters;
+};
+
+#endif
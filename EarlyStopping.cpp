@@ -0,0 +1,127 @@
+#include "EarlyStopping.hpp"
+#include <algorithm>
+#include <random>
+using namespace std;
+
+EarlyStoppingConfig::EarlyStoppingConfig() {
+    maxEpochs = 100;
+    patience = 6;
+    minDelta = 0.0005;
+    plateauPatience = 2;
+    learningRateFactor = 0.5;
+    minLearningRate = 1e-6;
+    subsampleSize = 256;
+    subsampleTolerance = 0;
+    seed = 1;
+}
+
+TrainingHistory::TrainingHistory() {
+    epochs = 0;
+    bestEpoch = -1;
+    bestAccuracy = -1;
+    fullEvaluations = 0;
+}
+
+TrainingHistory trainWithEarlyStopping(NeuralNetwork& nn, const vector<DataInstance>& trainData,
+                                       const vector<DataInstance>& validationData, EarlyStoppingConfig config) {
+    if (trainData.empty() || validationData.empty()) {
+        cerr << "Early stopping needs non-empty training and validation data" << endl;
+        exit(1);
+    }
+    if (config.maxEpochs < 1 || config.patience < 1 || config.plateauPatience < 1) {
+        cerr << "Early stopping needs maxEpochs, patience and plateauPatience of at least 1" << endl;
+        exit(1);
+    }
+    if (config.subsampleSize < 1) {
+        cerr << "Early stopping needs a subsample of at least 1 instance, but got " << config.subsampleSize << endl;
+        exit(1);
+    }
+    if (config.learningRateFactor <= 0 || config.learningRateFactor >= 1) {
+        cerr << "Early stopping needs a learning rate factor between 0 and 1, but got " << config.learningRateFactor << endl;
+        exit(1);
+    }
+    if (config.minDelta < 0 || config.subsampleTolerance < 0) {
+        cerr << "Early stopping needs a non-negative minDelta and subsampleTolerance" << endl;
+        exit(1);
+    }
+
+    // pick the subsample once so that its scores are comparable between epochs
+    vector<int> subsample(validationData.size());
+    for (int i = 0; i < subsample.size(); i++) {
+        subsample[i] = i;
+    }
+    mt19937 gen(config.seed);
+    shuffle(subsample.begin(), subsample.end(), gen);
+    subsample.resize(min<size_t>(config.subsampleSize, subsample.size()));
+
+    // score one subsample instance after every stride training instances
+    size_t stride = max<size_t>(1, trainData.size() / subsample.size());
+
+    TrainingHistory history;
+    vector<double> bestParameters;
+    double bestSubsampleAccuracy = -1;
+    int epochsSinceBest = 0;
+
+    for (int epoch = 0; epoch < config.maxEpochs; epoch++) {
+        double subsampleCorrect = 0;
+        int scored = 0;
+
+        nn.train();
+        for (size_t j = 0; j < trainData.size(); j++) {
+            nn.predict(trainData[j]);
+
+            if ((j + 1) % stride == 0 && scored < subsample.size()) {
+                const DataInstance& di = validationData[subsample[scored++]];
+                nn.eval();
+                if (static_cast<int>(round(nn.predict(di).at(0))) == di.y) {
+                    subsampleCorrect++;
+                }
+                nn.train();
+            }
+        }
+
+        // training sets smaller than the subsample score the rest here
+        nn.eval();
+        while (scored < subsample.size()) {
+            const DataInstance& di = validationData[subsample[scored++]];
+            if (static_cast<int>(round(nn.predict(di).at(0))) == di.y) {
+                subsampleCorrect++;
+            }
+        }
+        nn.train();
+
+        double subsampleAccuracy = subsampleCorrect / subsample.size();
+        history.subsampleAccuracies.push_back(subsampleAccuracy);
+        history.learningRates.push_back(nn.getLearningRate());
+
+        // the weights have not been updated yet, so a full evaluation still sees this epoch's weights
+        bool improved = false;
+        if (subsampleAccuracy > bestSubsampleAccuracy - config.subsampleTolerance) {
+            double accuracy = nn.assess(validationData);
+            history.fullEvaluations++;
+            bestSubsampleAccuracy = max(bestSubsampleAccuracy, subsampleAccuracy);
+            if (accuracy > history.bestAccuracy + config.minDelta) {
+                history.bestAccuracy = accuracy;
+                history.bestEpoch = epoch;
+                bestParameters = nn.getParameters();
+                improved = true;
+            }
+        }
+
+        nn.update();
+        history.epochs = epoch + 1;
+
+        epochsSinceBest = improved ? 0 : epochsSinceBest + 1;
+        if (epochsSinceBest >= config.patience) {
+            break;
+        }
+        if (epochsSinceBest > 0 && epochsSinceBest % config.plateauPatience == 0) {
+            nn.setLearningRate(max(config.minLearningRate, nn.getLearningRate() * config.learningRateFactor));
+        }
+    }
+
+    if (!bestParameters.empty()) {
+        nn.setParameters(bestParameters);
+    }
+    return history;
+}
@@ -0,0 +1,41 @@
+#ifndef EARLY_STOPPING_HPP
+#define EARLY_STOPPING_HPP
+
+#include "NeuralNetwork.hpp"
+
+// EarlyStoppingConfig controls trainWithEarlyStopping, which rejects invalid values up front
+struct EarlyStoppingConfig {
+    EarlyStoppingConfig();
+
+    int maxEpochs;
+    int patience; // epochs without a new best before training stops
+    double minDelta; // smallest accuracy gain that counts as a new best
+    int plateauPatience; // epochs without a new best before the learning rate is reduced
+    double learningRateFactor; // multiplies the learning rate on a plateau, between 0 and 1
+    double minLearningRate;
+    int subsampleSize; // validation instances scored during every epoch, at least 1; capped at the validation size
+    double subsampleTolerance; // how far below its best the subsample may score and still trigger a full evaluation
+    unsigned int seed; // picks the subsample
+};
+
+// TrainingHistory summarizes a trainWithEarlyStopping run
+struct TrainingHistory {
+    TrainingHistory();
+
+    int epochs; // epochs trained
+    int bestEpoch; // epoch whose weights were kept
+    double bestAccuracy; // full validation accuracy of the kept weights
+    int fullEvaluations; // number of full passes over the validation data
+    std::vector<double> subsampleAccuracies; // per epoch
+    std::vector<double> learningRates; // per epoch
+};
+
+// trains nn until the validation accuracy stops improving and leaves it with the best weights seen.
+// Every epoch scores a fixed validation subsample, interleaved with the training instances
+// (the weights only change at update, so these scores belong to the epoch's weights). The full
+// validation set is only assessed when the subsample suggests a new best, and the best weights
+// are kept in memory. The learning rate is reduced whenever the accuracy plateaus.
+TrainingHistory trainWithEarlyStopping(NeuralNetwork& nn, const std::vector<DataInstance>& trainData,
+                                       const std::vector<DataInstance>& validationData, EarlyStoppingConfig config);
+
+#endif
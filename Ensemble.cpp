@@ -0,0 +1,154 @@
+#include "Ensemble.hpp"
+using namespace std;
+
+Ensemble::Ensemble(vector<string> modelFiles) {
+    inputSize = 0;
+    inputActivation = nullptr;
+    for (int m = 0; m < modelFiles.size(); m++) {
+        NeuralNetwork nn(modelFiles.at(m));
+        addMember(nn);
+    }
+    checkMembers();
+}
+
+Ensemble::Ensemble(const vector<const NeuralNetwork*>& members) {
+    inputSize = 0;
+    inputActivation = nullptr;
+    for (int m = 0; m < members.size(); m++) {
+        addMember(*members.at(m));
+    }
+    checkMembers();
+}
+
+void Ensemble::checkMembers() const {
+    if (members.empty()) {
+        cerr << "Ensemble needs at least 1 member" << endl;
+        exit(1);
+    }
+}
+
+void Ensemble::addMember(const NeuralNetwork& nn) {
+    DenseModel model(nn);
+    const DenseLayout& layout = model.getLayout();
+    const vector<double>& parameters = model.getParameters();
+
+    vector<double> bias(parameters.begin() + layout.biasOffsets[0], parameters.begin() + layout.biasOffsets[0] + layout.layerSizes[0]);
+    if (members.empty()) {
+        inputSize = layout.layerSizes[0];
+        inputBias = bias;
+        inputActivation = layout.activationFunctions[0];
+    } else if (layout.layerSizes[0] != inputSize || bias != inputBias || layout.activationFunctions[0] != inputActivation) {
+        cerr << "Ensemble member " << members.size() << " is not compatible: every member needs the same input layer" << endl;
+        exit(1);
+    }
+
+    memberRows.push_back(stackedBias.size());
+    stackedWeights.insert(stackedWeights.end(), parameters.begin() + layout.weightOffsets[1],
+                          parameters.begin() + layout.weightOffsets[1] + layout.layerSizes[1] * inputSize);
+    stackedBias.insert(stackedBias.end(), parameters.begin() + layout.biasOffsets[1],
+                       parameters.begin() + layout.biasOffsets[1] + layout.layerSizes[1]);
+    stackedActivations.insert(stackedActivations.end(), layout.layerSizes[1], layout.activationFunctions[1]);
+
+    members.push_back(model);
+}
+
+int Ensemble::getNumMembers() const {
+    return members.size();
+}
+
+vector<double> Ensemble::predict(const vector<DataInstance>& batch, EnsembleCombine combine) const {
+    int batchLength = batch.size();
+    int rows = stackedBias.size();
+
+    // read and transform every input once
+    vector<double> input(batchLength * inputSize);
+    for (int b = 0; b < batchLength; b++) {
+        if (batch[b].x.size() != inputSize) {
+            cerr << "input size mismatch." << endl;
+            cerr << "\tEnsemble expected input size: " << inputSize << endl;
+            cerr << "\tBut got: " << batch[b].x.size() << endl;
+            return vector<double>();
+        }
+        for (int i = 0; i < inputSize; i++) {
+            input[b * inputSize + i] = inputActivation(batch[b].x[i] + inputBias[i]);
+        }
+    }
+
+    // one wide layer for all members: hidden[b][r]
+    vector<double> hidden(batchLength * rows);
+    for (int b = 0; b < batchLength; b++) {
+        const double* x = &input[b * inputSize];
+        for (int r = 0; r < rows; r++) {
+            const double* w = &stackedWeights[r * inputSize];
+            double sum = 0;
+            for (int i = 0; i < inputSize; i++) {
+                sum += x[i] * w[i];
+            }
+            hidden[b * rows + r] = stackedActivations[r](sum + stackedBias[r]);
+        }
+    }
+
+    vector<double> scores(batchLength, 0);
+    vector<double> previous, current;
+    for (int m = 0; m < members.size(); m++) {
+        const DenseLayout& layout = members[m].getLayout();
+        const double* parameters = members[m].getParameters().data();
+        int numLayers = layout.layerSizes.size();
+
+        // the member's slice of the wide layer, [b][j]
+        int width = layout.layerSizes[1];
+        previous.resize(batchLength * width);
+        for (int b = 0; b < batchLength; b++) {
+            for (int j = 0; j < width; j++) {
+                previous[b * width + j] = hidden[b * rows + memberRows[m] + j];
+            }
+        }
+
+        for (int l = 2; l < numLayers; l++) {
+            int fanIn = layout.layerSizes[l-1];
+            int size = layout.layerSizes[l];
+            const double* w = parameters + layout.weightOffsets[l];
+            const double* bias = parameters + layout.biasOffsets[l];
+            FuncSig activation = layout.activationFunctions[l];
+
+            current.assign(batchLength * size, 0);
+            for (int b = 0; b < batchLength; b++) {
+                for (int j = 0; j < size; j++) {
+                    double sum = 0;
+                    for (int i = 0; i < fanIn; i++) {
+                        sum += previous[b * fanIn + i] * w[j * fanIn + i];
+                    }
+                    current[b * size + j] = activation(sum + bias[j]);
+                }
+            }
+            previous.swap(current);
+            width = size;
+        }
+
+        for (int b = 0; b < batchLength; b++) {
+            double p = previous[b * width];
+            scores[b] += (combine == EnsembleCombine::Vote) ? round(p) : p;
+        }
+    }
+
+    for (int b = 0; b < batchLength; b++) {
+        scores[b] /= members.size();
+    }
+    return scores;
+}
+
+double Ensemble::assess(const vector<DataInstance>& data, EnsembleCombine combine) const {
+    if (data.empty()) {
+        cerr << "Cannot assess accuracy on an empty dataset" << endl;
+        exit(1);
+    }
+
+    vector<double> scores = predict(data, combine);
+    double correct = 0;
+    for (size_t j = 0; j < data.size(); j++) {
+        if (static_cast<int>(round(scores.at(j))) == data[j].y) {
+            correct++;
+        }
+    }
+    return correct / data.size();
+}
@@ -0,0 +1,45 @@
+#ifndef ENSEMBLE_HPP
+#define ENSEMBLE_HPP
+
+#include "DenseModel.hpp"
+
+// EnsembleCombine selects how member scores become the ensemble's score
+enum class EnsembleCombine {
+    Mean, // average of the members' first outputs
+    Vote // fraction of members whose first output rounds to 1
+};
+
+// Ensemble scores a batch with several compatible models in one pass.
+// The members' first layers after the input are stacked into one wide matrix, so every
+// input is transformed once and multiplied once; the remaining layers of every member
+// then run over the whole batch. Members must share the same input layer (size,
+// activation and biases) and are scored on their first output; there must be at least one.
+class Ensemble {
+
+    public:
+        Ensemble(std::vector<std::string> modelFiles);
+        Ensemble(const std::vector<const NeuralNetwork*>& members);
+
+        int getNumMembers() const;
+
+        // one combined score per instance of batch
+        std::vector<double> predict(const std::vector<DataInstance>& batch, EnsembleCombine combine) const;
+        double assess(const std::vector<DataInstance>& data, EnsembleCombine combine) const;
+
+    private:
+        void addMember(const NeuralNetwork& nn);
+        void checkMembers() const; // an ensemble needs at least one member
+
+        std::vector<DenseModel> members;
+        int inputSize;
+        std::vector<double> inputBias;
+        FuncSig inputActivation;
+
+        // stacked first layer: rows of every member one after another, row r = [stackedWeights + r * inputSize]
+        std::vector<double> stackedWeights;
+        std::vector<double> stackedBias;
+        std::vector<FuncSig> stackedActivations;
+        std::vector<int> memberRows; // first stacked row of every member
+};
+
+#endif
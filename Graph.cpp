@@ -110,9 +110,10 @@ void Graph::updateConnection(int v, int u, double w) {
 }
 
 void Graph::clear() {
-    for (int i; i < nodes.size(); i++) {
+    for (int i = 0; i < nodes.size(); i++) {
         delete nodes[i];
     }
+    nodes.clear();
     return;
 }
 
@@ -153,6 +154,10 @@ AdjList& Graph::getAdjacencyList() {
     return adjacencyList;
 }
 
+const AdjList& Graph::getAdjacencyList() const {
+    return adjacencyList;
+}
+
 ostream& operator<<(ostream& out, const Graph& g) {
     // output as dot format for graph visualization
     out << "digraph G {" << endl;
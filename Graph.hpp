@@ -73,6 +73,7 @@ class Graph {
         void updateConnection(int v, int u, double w);
 
         AdjList& getAdjacencyList();
+        const AdjList& getAdjacencyList() const;
 
         friend std::ostream& operator<<(std::ostream& out, const Graph& g);
         void resize(int size);
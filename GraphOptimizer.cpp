@@ -0,0 +1,199 @@
+#include "GraphOptimizer.hpp"
+#include "DenseModel.hpp"
+#include "NetworkBuilder.hpp"
+using namespace std;
+
+// one layer of the network being optimized
+struct OptimizerLayer {
+    string activation;
+    vector<double> bias;
+    vector<vector<double> > weights; // [dest][source], from the previous layer, empty for the input layer
+};
+
+OptimizationReport::OptimizationReport() {
+    nodesBefore = 0;
+    nodesAfter = 0;
+    weightsBefore = 0;
+    weightsAfter = 0;
+    layersCollapsed = 0;
+    deadNodesRemoved = 0;
+}
+
+static vector<OptimizerLayer> toLayers(const NeuralNetwork& nn) {
+    DenseModel model(nn);
+    const DenseLayout& layout = model.getLayout();
+    const vector<double>& parameters = model.getParameters();
+
+    vector<OptimizerLayer> layers(layout.layerSizes.size());
+    for (int l = 0; l < layers.size(); l++) {
+        int size = layout.layerSizes[l];
+        layers[l].activation = layout.activations[l];
+        layers[l].bias.assign(parameters.begin() + layout.biasOffsets[l], parameters.begin() + layout.biasOffsets[l] + size);
+
+        if (l == 0) continue;
+        int fanIn = layout.layerSizes[l-1];
+        for (int j = 0; j < size; j++) {
+            const double* row = parameters.data() + layout.weightOffsets[l] + j * fanIn;
+            layers[l].weights.push_back(vector<double>(row, row + fanIn));
+        }
+    }
+    return layers;
+}
+
+static NeuralNetwork toNetwork(const vector<OptimizerLayer>& layers) {
+    NetworkBuilder builder;
+    for (int l = 0; l < layers.size(); l++) {
+        builder.addLayer(layers[l].bias.size(), layers[l].activation);
+    }
+    NeuralNetwork nn = builder.build();
+
+    vector<vector<int> > ids = nn.getLayers();
+    for (int l = 0; l < layers.size(); l++) {
+        for (int j = 0; j < ids[l].size(); j++) {
+            nn.getNode(ids[l][j])->bias = layers[l].bias[j];
+
+            if (l == 0) continue;
+            for (int i = 0; i < ids[l-1].size(); i++) {
+                nn.updateConnection(ids[l-1][i], ids[l][j], layers[l].weights[j][i]);
+            }
+        }
+    }
+    return nn;
+}
+
+static void countSize(const vector<OptimizerLayer>& layers, int& nodes, int& weights) {
+    nodes = 0;
+    weights = 0;
+    for (int l = 0; l < layers.size(); l++) {
+        nodes += layers[l].bias.size();
+        if (l > 0) {
+            weights += layers[l].bias.size() * layers[l-1].bias.size();
+        }
+    }
+}
+
+// input node i computes (x_i - m_i) / s_i + b_i, so the first layer sees x_i / s_i plus a constant
+static void foldNormalization(vector<OptimizerLayer>& layers, const vector<double>& mean, const vector<double>& stdDev) {
+    OptimizerLayer& input = layers[0];
+    OptimizerLayer& first = layers[1];
+
+    if (input.activation != "identity") {
+        cerr << "Cannot fold normalization through a " << input.activation << " input layer" << endl;
+        exit(1);
+    }
+    if (mean.size() != input.bias.size() || stdDev.size() != input.bias.size()) {
+        cerr << "normalization size mismatch." << endl;
+        cerr << "\tNeuralNet expected input size: " << input.bias.size() << endl;
+        cerr << "\tBut got: " << mean.size() << endl;
+        exit(1);
+    }
+
+    for (int i = 0; i < input.bias.size(); i++) {
+        // a constant feature has no spread to scale by, it only keeps its bias
+        double scale = (stdDev[i] > 0) ? 1 / stdDev[i] : 0;
+        double offset = input.bias[i] - mean[i] * scale;
+
+        for (int j = 0; j < first.bias.size(); j++) {
+            first.bias[j] += first.weights[j][i] * offset;
+            first.weights[j][i] *= scale;
+        }
+        input.bias[i] = 0;
+    }
+}
+
+// replaces hidden identity layer l by the product of its weights and the next layer's weights
+static bool collapseIdentityLayer(vector<OptimizerLayer>& layers, int l) {
+    OptimizerLayer& middle = layers[l];
+    OptimizerLayer& next = layers[l+1];
+    int fanIn = layers[l-1].bias.size();
+    int width = middle.bias.size();
+    int fanOut = next.bias.size();
+
+    // only worth it when the merged layer multiplies less than the two it replaces
+    if (fanIn * fanOut > fanIn * width + width * fanOut) {
+        return false;
+    }
+
+    vector<vector<double> > weights(fanOut, vector<double>(fanIn, 0));
+    for (int k = 0; k < fanOut; k++) {
+        for (int j = 0; j < width; j++) {
+            next.bias[k] += next.weights[k][j] * middle.bias[j];
+            for (int i = 0; i < fanIn; i++) {
+                weights[k][i] += next.weights[k][j] * middle.weights[j][i];
+            }
+        }
+    }
+    next.weights = weights;
+    layers.erase(layers.begin() + l);
+    return true;
+}
+
+// removes node j of hidden layer l
+static void removeNode(vector<OptimizerLayer>& layers, int l, int j) {
+    layers[l].bias.erase(layers[l].bias.begin() + j);
+    layers[l].weights.erase(layers[l].weights.begin() + j);
+    for (int k = 0; k < layers[l+1].weights.size(); k++) {
+        layers[l+1].weights[k].erase(layers[l+1].weights[k].begin() + j);
+    }
+}
+
+static int removeDeadNodes(vector<OptimizerLayer>& layers) {
+    int removed = 0;
+
+    // backwards: a hidden node whose outgoing weights are all zero never reaches an output
+    for (int l = layers.size() - 2; l >= 1; l--) {
+        for (int j = layers[l].bias.size() - 1; j >= 0 && layers[l].bias.size() > 1; j--) {
+            bool reachesOutput = false;
+            for (int k = 0; k < layers[l+1].bias.size(); k++) {
+                reachesOutput = reachesOutput || layers[l+1].weights[k][j] != 0;
+            }
+            if (!reachesOutput) {
+                removeNode(layers, l, j);
+                removed++;
+            }
+        }
+    }
+
+    // forwards: a hidden node whose incoming weights are all zero is a constant,
+    // which the next layer can absorb into its biases
+    for (int l = 1; l + 1 < layers.size(); l++) {
+        for (int j = layers[l].bias.size() - 1; j >= 0 && layers[l].bias.size() > 1; j--) {
+            bool dependsOnInput = false;
+            for (int i = 0; i < layers[l].weights[j].size(); i++) {
+                dependsOnInput = dependsOnInput || layers[l].weights[j][i] != 0;
+            }
+            if (!dependsOnInput) {
+                double constant = getActivationFunction(layers[l].activation)(layers[l].bias[j]);
+                for (int k = 0; k < layers[l+1].bias.size(); k++) {
+                    layers[l+1].bias[k] += layers[l+1].weights[k][j] * constant;
+                }
+                removeNode(layers, l, j);
+                removed++;
+            }
+        }
+    }
+    return removed;
+}
+
+NeuralNetwork optimizeNetwork(const NeuralNetwork& nn, const vector<double>& mean, const vector<double>& stdDev,
+                              OptimizationReport& report) {
+    vector<OptimizerLayer> layers = toLayers(nn);
+    countSize(layers, report.nodesBefore, report.weightsBefore);
+
+    foldNormalization(layers, mean, stdDev);
+
+    for (int l = 1; l + 1 < layers.size(); ) {
+        if (layers[l].activation == "identity" && collapseIdentityLayer(layers, l)) {
+            report.layersCollapsed++;
+        } else {
+            l++;
+        }
+    }
+
+    report.deadNodesRemoved = removeDeadNodes(layers);
+    countSize(layers, report.nodesAfter, report.weightsAfter);
+
+    NeuralNetwork optimized = toNetwork(layers);
+    optimized.setLearningRate(nn.getLearningRate());
+    return optimized;
+}
@@ -0,0 +1,28 @@
+#ifndef GRAPH_OPTIMIZER_HPP
+#define GRAPH_OPTIMIZER_HPP
+
+#include "NeuralNetwork.hpp"
+
+// OptimizationReport describes what optimizeNetwork changed
+struct OptimizationReport {
+    OptimizationReport();
+
+    int nodesBefore;
+    int nodesAfter;
+    int weightsBefore;
+    int weightsAfter;
+    int layersCollapsed; // identity hidden layers merged into their neighbours
+    int deadNodesRemoved; // hidden nodes without a path to the outputs or from the inputs
+};
+
+// Returns an equivalent, smaller network for serving:
+//  - the per-feature standardization (x - mean) / stdDev is folded into the first layer's
+//    weights and biases, so the result takes raw features (the input layer must be identity)
+//  - identity hidden layers are multiplied into the next layer when that is less arithmetic
+//  - hidden nodes whose outgoing weights are all zero are dropped, and hidden nodes that do not
+//    depend on the inputs are folded into the next layer's biases
+// nn must be layered and fully connected, as built by loadNetwork or NetworkBuilder.
+NeuralNetwork optimizeNetwork(const NeuralNetwork& nn, const std::vector<double>& mean, const std::vector<double>& stdDev,
+                              OptimizationReport& report);
+
+#endif
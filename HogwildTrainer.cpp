@@ -0,0 +1,230 @@
+#include "HogwildTrainer.hpp"
+#include <chrono>
+using namespace std;
+
+TrainingStats::TrainingStats() {
+    seconds = 0;
+    samplesPerSecond = 0;
+    accuracy = -1;
+}
+
+HogwildTrainer::HogwildTrainer(const NeuralNetwork& nn) {
+    DenseModel model(nn);
+    layout = model.getLayout();
+    learningRate = nn.getLearningRate();
+
+    numNodes = 0;
+    for (int l = 0; l < layout.layerSizes.size(); l++) {
+        derivatives.push_back(getActivationDerivative(layout.activations[l]));
+        nodeOffsets.push_back(numNodes);
+        numNodes += layout.layerSizes[l];
+    }
+
+    parameters.reset(new atomic<double>[layout.numParameters]);
+    for (int k = 0; k < layout.numParameters; k++) {
+        parameters[k].store(model.getParameters()[k]);
+    }
+}
+
+void HogwildTrainer::setLearningRate(double lr) {
+    learningRate = lr;
+}
+
+HogwildTrainer::Scratch HogwildTrainer::makeScratch() const {
+    Scratch scratch;
+    scratch.z.assign(numNodes, 0);
+    scratch.a.assign(numNodes, 0);
+    scratch.g.assign(numNodes, 0);
+    return scratch;
+}
+
+void HogwildTrainer::step(const DataInstance& instance, Scratch& scratch, double* accumulator) {
+    const memory_order relaxed = memory_order_relaxed;
+    int numLayers = layout.layerSizes.size();
+    double* z = scratch.z.data();
+    double* a = scratch.a.data();
+    double* g = scratch.g.data();
+
+    for (int i = 0; i < layout.layerSizes[0]; i++) {
+        z[i] = instance.x[i] + parameters[layout.biasOffsets[0] + i].load(relaxed);
+        a[i] = layout.activationFunctions[0](z[i]);
+    }
+
+    for (int l = 1; l < numLayers; l++) {
+        int fanIn = layout.layerSizes[l-1];
+        const atomic<double>* w = &parameters[layout.weightOffsets[l]];
+        const atomic<double>* bias = &parameters[layout.biasOffsets[l]];
+        const double* previous = a + nodeOffsets[l-1];
+
+        for (int j = 0; j < layout.layerSizes[l]; j++) {
+            double sum = 0;
+            for (int i = 0; i < fanIn; i++) {
+                sum += previous[i] * w[j * fanIn + i].load(relaxed);
+            }
+            int node = nodeOffsets[l] + j;
+            z[node] = sum + bias[j].load(relaxed);
+            a[node] = layout.activationFunctions[l](z[node]);
+        }
+    }
+
+    // every output node is seeded from the first output, as in NeuralNetwork::contribute
+    double y = instance.y;
+    double p = a[nodeOffsets[numLayers-1]];
+    for (int j = 0; j < layout.layerSizes[numLayers-1]; j++) {
+        int node = nodeOffsets[numLayers-1] + j;
+        g[node] = -1 * ((y - p) / (p * (1 - p))) * derivatives[numLayers-1](z[node]);
+    }
+
+    for (int l = numLayers - 1; l >= 1; l--) {
+        int fanIn = layout.layerSizes[l-1];
+        atomic<double>* w = &parameters[layout.weightOffsets[l]];
+        const double* previous = a + nodeOffsets[l-1];
+        const double* next = g + nodeOffsets[l];
+
+        // the previous layer's contributions need the weights from before this instance's update
+        if (l > 1) {
+            for (int i = 0; i < fanIn; i++) {
+                double sum = 0;
+                for (int j = 0; j < layout.layerSizes[l]; j++) {
+                    sum += w[j * fanIn + i].load(relaxed) * next[j];
+                }
+                int node = nodeOffsets[l-1] + i;
+                g[node] = sum * derivatives[l-1](z[node]);
+            }
+        }
+
+        for (int j = 0; j < layout.layerSizes[l]; j++) {
+            int biasIndex = layout.biasOffsets[l] + j;
+            if (accumulator) {
+                accumulator[biasIndex] += next[j];
+                for (int i = 0; i < fanIn; i++) {
+                    accumulator[layout.weightOffsets[l] + j * fanIn + i] += next[j] * previous[i];
+                }
+            } else {
+                // racy but bounded: a concurrent update of the same parameter may be lost, never torn
+                parameters[biasIndex].store(parameters[biasIndex].load(relaxed) - learningRate * next[j], relaxed);
+                for (int i = 0; i < fanIn; i++) {
+                    atomic<double>& weight = w[j * fanIn + i];
+                    weight.store(weight.load(relaxed) - learningRate * next[j] * previous[i], relaxed);
+                }
+            }
+        }
+    }
+}
+
+TrainingStats HogwildTrainer::trainAsync(const vector<DataInstance>& data, int numEpochs, ThreadPool& pool,
+                                         const vector<DataInstance>& evaluationData) {
+    checkData(data);
+    checkData(evaluationData);
+    int numThreads = pool.getNumThreads();
+    auto start = chrono::steady_clock::now();
+
+    for (int epoch = 0; epoch < numEpochs; epoch++) {
+        pool.parallelFor(0, numThreads, [&](int t) {
+            Scratch scratch = makeScratch();
+            for (size_t j = t; j < data.size(); j += numThreads) {
+                step(data[j], scratch, nullptr);
+            }
+        });
+    }
+
+    TrainingStats stats;
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stats.samplesPerSecond = numEpochs * data.size() / stats.seconds;
+    if (!evaluationData.empty()) {
+        stats.accuracy = assess(evaluationData);
+    }
+    return stats;
+}
+
+TrainingStats HogwildTrainer::trainSync(const vector<DataInstance>& data, int numEpochs, int batchSize, ThreadPool& pool,
+                                        const vector<DataInstance>& evaluationData) {
+    checkData(data);
+    checkData(evaluationData);
+    int numThreads = pool.getNumThreads();
+    batchSize = max(1, batchSize);
+    vector<vector<double> > accumulators(numThreads, vector<double>(layout.numParameters, 0));
+    vector<Scratch> scratches(numThreads, makeScratch());
+    auto start = chrono::steady_clock::now();
+
+    for (int epoch = 0; epoch < numEpochs; epoch++) {
+        for (size_t begin = 0; begin < data.size(); begin += batchSize) {
+            size_t end = min(data.size(), begin + batchSize);
+
+            // parallelFor returns once every thread is done: the barrier before the update
+            pool.parallelFor(0, numThreads, [&](int t) {
+                for (size_t j = begin + t; j < end; j += numThreads) {
+                    step(data[j], scratches[t], accumulators[t].data());
+                }
+            });
+
+            // the mean gradient, so the step size does not grow with the batch size
+            for (int k = 0; k < layout.numParameters; k++) {
+                double gradient = 0;
+                for (int t = 0; t < numThreads; t++) {
+                    gradient += accumulators[t][k];
+                    accumulators[t][k] = 0;
+                }
+                parameters[k].store(parameters[k].load() - learningRate * gradient / (end - begin));
+            }
+        }
+    }
+
+    TrainingStats stats;
+    stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    stats.samplesPerSecond = numEpochs * data.size() / stats.seconds;
+    if (!evaluationData.empty()) {
+        stats.accuracy = assess(evaluationData);
+    }
+    return stats;
+}
+
+vector<double> HogwildTrainer::getParameters() const {
+    vector<double> values(layout.numParameters);
+    for (int k = 0; k < layout.numParameters; k++) {
+        values[k] = parameters[k].load();
+    }
+    return values;
+}
+
+void HogwildTrainer::checkData(const vector<DataInstance>& data) const {
+    for (size_t j = 0; j < data.size(); j++) {
+        if (data[j].sparse) {
+            cerr << "HogwildTrainer only trains on dense instances, but instance " << j << " is sparse" << endl;
+            exit(1);
+        }
+        if (data[j].x.size() != layout.layerSizes[0]) {
+            cerr << "input size mismatch." << endl;
+            cerr << "\tHogwildTrainer expected input size: " << layout.layerSizes[0] << endl;
+            cerr << "\tBut instance " << j << " has: " << data[j].x.size() << endl;
+            exit(1);
+        }
+    }
+}
+
+double HogwildTrainer::assess(const vector<DataInstance>& data) const {
+    vector<double> values = getParameters();
+    double correct = 0;
+    for (size_t j = 0; j < data.size(); j++) {
+        if (static_cast<int>(round(denseForward(layout, values.data(), data[j].x).at(0))) == data[j].y) {
+            correct++;
+        }
+    }
+    return correct / data.size();
+}
+
+void HogwildTrainer::copyTo(NeuralNetwork& nn) const {
+    vector<vector<int> > layers = nn.getLayers();
+    vector<double> values = getParameters();
+
+    for (int l = 0; l < layers.size(); l++) {
+        for (int j = 0; j < layers[l].size(); j++) {
+            nn.getNode(layers[l][j])->bias = values[layout.biasOffsets[l] + j];
+
+            if (l == 0) continue;
+            for (int i = 0; i < layers[l-1].size(); i++) {
+                nn.updateConnection(layers[l-1][i], layers[l][j], values[layout.weightOffsets[l] + j * layers[l-1].size() + i]);
+            }
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef HOGWILD_TRAINER_HPP
+#define HOGWILD_TRAINER_HPP
+
+#include "DenseModel.hpp"
+#include "ThreadPool.hpp"
+#include <atomic>
+#include <memory>
+
+// TrainingStats describes one training run
+struct TrainingStats {
+    TrainingStats();
+    double seconds;
+    double samplesPerSecond;
+    double accuracy; // on the evaluation data passed to the trainer, -1 if none
+};
+
+// HogwildTrainer trains a copy of a layered NeuralNetwork with per-instance SGD on many threads.
+// The parameters are one shared array of doubles in DenseLayout order.
+//  - trainAsync (Hogwild): every thread runs forward and backward on its own instances and
+//    writes its updates straight into the shared parameters with relaxed atomic loads and
+//    stores; there are no locks or barriers, and an update that races with another may be lost.
+//  - trainSync: the synchronous baseline; the threads compute the gradients of one minibatch,
+//    wait for each other, and the minibatch's mean gradient is applied before the next one.
+// Both train on dense instances only and exit on sparse or wrongly sized ones.
+// The loss and its derivatives are the ones NeuralNetwork::contribute uses.
+class HogwildTrainer {
+
+    public:
+        HogwildTrainer(const NeuralNetwork& nn);
+
+        void setLearningRate(double lr);
+
+        TrainingStats trainAsync(const std::vector<DataInstance>& data, int numEpochs, ThreadPool& pool,
+                                 const std::vector<DataInstance>& evaluationData);
+        TrainingStats trainSync(const std::vector<DataInstance>& data, int numEpochs, int batchSize, ThreadPool& pool,
+                                const std::vector<DataInstance>& evaluationData);
+
+        std::vector<double> getParameters() const;
+        void copyTo(NeuralNetwork& nn) const; // writes the trained parameters back into nn
+
+    private:
+        // node values and contributions of one instance, owned by one thread
+        struct Scratch {
+            std::vector<double> z;
+            std::vector<double> a;
+            std::vector<double> g;
+        };
+
+        // computes one instance's gradient; with no accumulator it is applied to the shared
+        // parameters as soon as it is known, otherwise it is added to accumulator
+        void step(const DataInstance& instance, Scratch& scratch, double* accumulator);
+        double assess(const std::vector<DataInstance>& data) const;
+        Scratch makeScratch() const;
+        // step reads dense inputs without checks, so every instance is checked before training starts
+        void checkData(const std::vector<DataInstance>& data) const;
+
+        DenseLayout layout;
+        std::vector<FuncSig> derivatives;
+        std::vector<int> nodeOffsets; // index of every layer's first node in Scratch
+        int numNodes;
+        std::unique_ptr<std::atomic<double>[]> parameters;
+        double learningRate;
+};
+
+#endif
@@ -0,0 +1,132 @@
+#include "MappedModel.hpp"
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+static const char binaryModelMagic[8] = "NNDENSE";
+static const uint32_t binaryModelVersion = 1;
+
+void saveBinaryModel(const NeuralNetwork& nn, string filename) {
+    DenseModel model(nn);
+    const DenseLayout& layout = model.getLayout();
+
+    BinaryModelHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, binaryModelMagic, sizeof(header.magic));
+    header.version = binaryModelVersion;
+    header.numLayers = layout.layerSizes.size();
+    header.numParameters = layout.numParameters;
+
+    // align the parameters so the mapped doubles can be read directly
+    size_t end = sizeof(BinaryModelHeader) + header.numLayers * sizeof(BinaryModelLayer);
+    header.parameterOffset = (end + 63) / 64 * 64;
+
+    ofstream fout(filename, ios::binary);
+    if (fout.fail()) {
+        cerr << "Could not open " << filename << " for writing. " << endl;
+        exit(1);
+    }
+
+    fout.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (int l = 0; l < layout.layerSizes.size(); l++) {
+        BinaryModelLayer layer;
+        memset(&layer, 0, sizeof(layer));
+        layer.size = layout.layerSizes[l];
+        strncpy(layer.activation, layout.activations[l].c_str(), sizeof(layer.activation) - 1);
+        fout.write(reinterpret_cast<const char*>(&layer), sizeof(layer));
+    }
+
+    string padding(header.parameterOffset - end, '\0');
+    fout.write(padding.data(), padding.size());
+    fout.write(reinterpret_cast<const char*>(model.getParameters().data()), sizeof(double) * layout.numParameters);
+    fout.close();
+}
+
+MappedModel::MappedModel(string filename) {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Could not open " << filename << " for reading. " << endl;
+        exit(1);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < sizeof(BinaryModelHeader)) {
+        cerr << filename << " is not a binary model file" << endl;
+        exit(1);
+    }
+    size = info.st_size;
+
+    mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        cerr << "Could not map " << filename << ": " << strerror(errno) << endl;
+        exit(1);
+    }
+
+    const char* bytes = static_cast<const char*>(mapping);
+    const BinaryModelHeader* header = reinterpret_cast<const BinaryModelHeader*>(bytes);
+    if (memcmp(header->magic, binaryModelMagic, sizeof(header->magic)) != 0 || header->version != binaryModelVersion) {
+        cerr << filename << " is not a version " << binaryModelVersion << " binary model file" << endl;
+        exit(1);
+    }
+
+    size_t layersEnd = sizeof(BinaryModelHeader) + header->numLayers * sizeof(BinaryModelLayer);
+    if (header->numLayers < 2 || layersEnd > size) {
+        cerr << filename << " has a corrupt layer table" << endl;
+        exit(1);
+    }
+
+    if (header->parameterOffset < layersEnd || header->parameterOffset % sizeof(double) != 0 || header->parameterOffset > size) {
+        cerr << filename << " has a corrupt parameter table" << endl;
+        exit(1);
+    }
+
+    // check every layer before DenseLayout computes its int offsets: the parameter count
+    // must fit both the file and an int
+    uint64_t maxParameters = min<uint64_t>((size - header->parameterOffset) / sizeof(double), INT_MAX);
+    uint64_t numParameters = 0;
+    vector<int> layerSizes;
+    vector<string> activations;
+    const BinaryModelLayer* layers = reinterpret_cast<const BinaryModelLayer*>(bytes + sizeof(BinaryModelHeader));
+    for (int l = 0; l < header->numLayers; l++) {
+        uint64_t layerSize = layers[l].size;
+        numParameters += layerSize + ((l > 0) ? layerSize * layerSizes.back() : 0);
+        if (layerSize == 0 || layerSize > maxParameters || numParameters > maxParameters) {
+            cerr << filename << " has a corrupt layer table: layer " << l << " has " << layerSize << " nodes" << endl;
+            exit(1);
+        }
+
+        string activation(layers[l].activation, strnlen(layers[l].activation, sizeof(layers[l].activation)));
+        if (getActivationIdentifier(getActivationFunction(activation)) != activation) {
+            cerr << filename << " has an unknown activation for layer " << l << ": " << activation << endl;
+            exit(1);
+        }
+
+        layerSizes.push_back(layerSize);
+        activations.push_back(activation);
+    }
+
+    if (numParameters != header->numParameters) {
+        cerr << filename << " has a corrupt parameter table" << endl;
+        exit(1);
+    }
+    layout = DenseLayout(layerSizes, activations);
+    parameters = reinterpret_cast<const double*>(bytes + header->parameterOffset);
+}
+
+MappedModel::~MappedModel() {
+    munmap(mapping, size);
+}
+
+vector<double> MappedModel::predict(const DataInstance& instance) const {
+    return denseForward(layout, parameters, instance.x);
+}
+
+const DenseLayout& MappedModel::getLayout() const {
+    return layout;
+}
@@ -0,0 +1,48 @@
+#ifndef MAPPED_MODEL_HPP
+#define MAPPED_MODEL_HPP
+
+#include "DenseModel.hpp"
+#include <cstdint>
+
+// Binary model files hold a DenseModel in native byte order:
+//   a BinaryModelHeader, numLayers BinaryModelLayer records, then numParameters doubles
+//   in DenseLayout order starting at parameterOffset (a multiple of 64).
+struct BinaryModelHeader {
+    char magic[8]; // "NNDENSE\0"
+    uint32_t version;
+    uint32_t numLayers;
+    uint64_t numParameters;
+    uint64_t parameterOffset;
+};
+
+struct BinaryModelLayer {
+    uint32_t size;
+    char activation[28]; // activation identifier, e.g. "sigmoid"
+};
+
+// writes nn as a binary model file
+void saveBinaryModel(const NeuralNetwork& nn, std::string filename);
+
+// MappedModel serves a binary model file mapped read-only into memory.
+// The parameters are used in place, so every process mapping the same file shares
+// the same physical pages through the page cache and loading does no parsing or copying.
+class MappedModel {
+
+    public:
+        MappedModel(std::string filename);
+        ~MappedModel();
+
+        MappedModel(const MappedModel& other) = delete;
+        MappedModel& operator=(const MappedModel& other) = delete;
+
+        std::vector<double> predict(const DataInstance& instance) const;
+        const DenseLayout& getLayout() const;
+
+    private:
+        void* mapping;
+        size_t size;
+        DenseLayout layout;
+        const double* parameters; // points into mapping
+};
+
+#endif
@@ -0,0 +1,116 @@
+#include "ModelHandle.hpp"
+#include <algorithm>
+using namespace std;
+
+// Snapshot -----------------------------------------------------------------------------------------------------------------------------------
+
+ModelHandle::Snapshot::Snapshot(const NeuralNetwork& nn, unsigned long version) : model(nn) {
+    this->version = version;
+}
+
+// Reader -----------------------------------------------------------------------------------------------------------------------------------
+
+ModelHandle::Reader::Reader(ModelHandle& handle) : handle(handle) {
+    record = handle.acquireRecord();
+
+    // publish the hazard, then make sure it is still current; otherwise the writer may
+    // already have scanned the hazards and retired it, so try again
+    do {
+        snapshot = handle.current.load();
+        record->hazard.store(snapshot);
+    } while (snapshot != handle.current.load());
+}
+
+ModelHandle::Reader::~Reader() {
+    record->hazard.store(nullptr);
+    record->inUse.store(false);
+}
+
+const ModelHandle::Snapshot& ModelHandle::Reader::get() const {
+    return *snapshot;
+}
+
+// HazardRecord -----------------------------------------------------------------------------------------------------------------------------------
+
+ModelHandle::HazardRecord::HazardRecord() : hazard(nullptr), inUse(true) {
+    next = nullptr;
+}
+
+// ModelHandle -----------------------------------------------------------------------------------------------------------------------------------
+
+ModelHandle::ModelHandle(const NeuralNetwork& nn) {
+    records.store(nullptr);
+    nextVersion = 0;
+    currentVersion.store(nextVersion);
+    current.store(new Snapshot(nn, nextVersion++));
+}
+
+ModelHandle::~ModelHandle() {
+    for (int i = 0; i < retired.size(); i++) {
+        delete retired[i];
+    }
+    delete current.load();
+
+    HazardRecord* record = records.load();
+    while (record) {
+        HazardRecord* next = record->next;
+        delete record;
+        record = next;
+    }
+}
+
+void ModelHandle::publish(const NeuralNetwork& nn) {
+    lock_guard<mutex> guard(writerLock);
+
+    // the copy is made before the swap, so readers never see a partially built snapshot
+    const Snapshot* snapshot = new Snapshot(nn, nextVersion++);
+    retired.push_back(current.exchange(snapshot));
+    currentVersion.store(snapshot->version);
+    reclaim();
+}
+
+unsigned long ModelHandle::getVersion() const {
+    return currentVersion.load();
+}
+
+vector<double> ModelHandle::predict(const DataInstance& instance) {
+    Reader reader(*this);
+    return reader.get().model.predict(instance);
+}
+
+ModelHandle::HazardRecord* ModelHandle::acquireRecord() {
+    for (HazardRecord* record = records.load(); record; record = record->next) {
+        bool expected = false;
+        if (!record->inUse.load() && record->inUse.compare_exchange_strong(expected, true)) {
+            return record;
+        }
+    }
+
+    // every record is taken: add one rather than wait for a reader to finish
+    HazardRecord* record = new HazardRecord();
+    HazardRecord* head = records.load();
+    do {
+        record->next = head;
+    } while (!records.compare_exchange_weak(head, record));
+    return record;
+}
+
+void ModelHandle::reclaim() {
+    vector<const Snapshot*> pinned;
+    for (HazardRecord* record = records.load(); record; record = record->next) {
+        const Snapshot* hazard = record->hazard.load();
+        if (hazard) {
+            pinned.push_back(hazard);
+        }
+    }
+
+    vector<const Snapshot*> stillRetired;
+    for (int i = 0; i < retired.size(); i++) {
+        if (find(pinned.begin(), pinned.end(), retired[i]) != pinned.end()) {
+            stillRetired.push_back(retired[i]);
+        } else {
+            delete retired[i];
+        }
+    }
+    retired.swap(stillRetired);
+}
@@ -0,0 +1,79 @@
+#ifndef MODEL_HANDLE_HPP
+#define MODEL_HANDLE_HPP
+
+#include "DenseModel.hpp"
+#include <atomic>
+#include <mutex>
+
+// ModelHandle serves a model that keeps being retrained (read-copy-update).
+// The trainer publishes immutable DenseModel snapshots with an atomic pointer swap;
+// readers pin the current snapshot with a hazard pointer, so they never wait for the
+// trainer and a snapshot is only deleted once no reader has it pinned. Hazard records
+// are kept in a lock-free list that grows when every record is taken, so any number of
+// readers can hold a snapshot at the same time without waiting for each other.
+class ModelHandle {
+
+    private:
+        struct HazardRecord;
+
+    public:
+        // Snapshot is one published version of the model
+        struct Snapshot {
+            Snapshot(const NeuralNetwork& nn, unsigned long version);
+            DenseModel model;
+            unsigned long version;
+        };
+
+        // Reader pins the current snapshot for as long as it lives
+        class Reader {
+
+            public:
+                Reader(ModelHandle& handle);
+                ~Reader();
+
+                Reader(const Reader& other) = delete;
+                Reader& operator=(const Reader& other) = delete;
+
+                const Snapshot& get() const;
+
+            private:
+                ModelHandle& handle;
+                HazardRecord* record;
+                const Snapshot* snapshot;
+        };
+
+        ModelHandle(const NeuralNetwork& nn);
+        ~ModelHandle(); // readers must be gone
+
+        ModelHandle(const ModelHandle& other) = delete;
+        ModelHandle& operator=(const ModelHandle& other) = delete;
+
+        // makes a copy of nn's current parameters the version new readers see
+        void publish(const NeuralNetwork& nn);
+        unsigned long getVersion() const;
+
+        // scores instance with the current version, never blocking on publish
+        std::vector<double> predict(const DataInstance& instance);
+
+    private:
+        // one reader's hazard pointer; records are only ever added to the list, and reused
+        struct HazardRecord {
+            HazardRecord();
+            std::atomic<const Snapshot*> hazard; // snapshot pinned by the reader holding the record
+            std::atomic<bool> inUse;
+            HazardRecord* next;
+        };
+
+        HazardRecord* acquireRecord(); // claims a free record or appends a new one, never waits
+        void reclaim(); // deletes retired snapshots that no reader has pinned
+
+        std::atomic<const Snapshot*> current;
+        std::atomic<unsigned long> currentVersion; // version of current, readable without pinning it
+        std::atomic<HazardRecord*> records;
+
+        std::mutex writerLock; // serializes publishers, readers never take it
+        std::vector<const Snapshot*> retired;
+        unsigned long nextVersion;
+};
+
+#endif
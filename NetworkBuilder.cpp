@@ -0,0 +1,83 @@
+#include "NetworkBuilder.hpp"
+using namespace std;
+
+NetworkBuilder::NetworkBuilder() {
+    seed = 1;
+    init = WeightInit::Normal;
+    layerOffsets.push_back(0);
+}
+
+NetworkBuilder& NetworkBuilder::addLayer(int numNodes, string activation) {
+    if (numNodes <= 0) {
+        cerr << "Layer must have at least 1 node, but got " << numNodes << " nodes" << endl;
+        exit(1);
+    }
+    layerSizes.push_back(numNodes);
+    activations.push_back(activation);
+    layerOffsets.push_back(layerOffsets.back() + numNodes);
+    return *this;
+}
+
+NetworkBuilder& NetworkBuilder::setSeed(uint64_t seed) {
+    this->seed = seed;
+    return *this;
+}
+
+NetworkBuilder& NetworkBuilder::setWeightInit(WeightInit init) {
+    this->init = init;
+    return *this;
+}
+
+void NetworkBuilder::buildNode(NeuralNetwork& nn, int layer, int index) const {
+    int id = layerOffsets[layer] + index;
+    nn.nodes[id] = new NodeInfo(activations[layer], 0, 0);
+
+    if (layer + 1 == layerSizes.size()) return;
+
+    int fanIn = layerSizes[layer];
+    int fanOut = layerSizes[layer + 1];
+    double stdDev = 1;
+    if (init == WeightInit::Xavier) {
+        stdDev = sqrt(2.0 / (fanIn + fanOut));
+    } else if (init == WeightInit::He) {
+        stdDev = sqrt(2.0 / fanIn);
+    }
+
+    // only this node's own map is written, so nodes can be built concurrently
+    unordered_map<int, Connection>& edges = nn.adjacencyList[id];
+    edges.reserve(fanOut);
+    for (int j = 0; j < fanOut; j++) {
+        int dest = layerOffsets[layer + 1] + j;
+        double w = stdDev * sample(seed, layer + 1, static_cast<uint64_t>(j) * fanIn + index);
+        edges.emplace(dest, Connection(id, dest, w));
+    }
+}
+
+NeuralNetwork NetworkBuilder::build() const {
+    ThreadPool pool(1);
+    return build(pool);
+}
+
+NeuralNetwork NetworkBuilder::build(ThreadPool& pool) const {
+    if (layerSizes.size() <= 1) {
+        cerr << "Neural Network must have at least 2 layers, but got " << layerSizes.size() << " layers" << endl;
+        exit(1);
+    }
+
+    NeuralNetwork nn(layerOffsets.back());
+    vector<vector<int> > layers(layerSizes.size());
+
+    for (int l = 0; l < layerSizes.size(); l++) {
+        for (int j = 0; j < layerSizes[l]; j++) {
+            layers[l].push_back(layerOffsets[l] + j);
+        }
+        pool.parallelFor(0, layerSizes[l], [&](int j) {
+            buildNode(nn, l, j);
+        });
+    }
+
+    nn.setLayers(layers);
+    nn.setInputNodeIds(layers.front());
+    nn.setOutputNodeIds(layers.back());
+    return nn;
+}
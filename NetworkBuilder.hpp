@@ -0,0 +1,41 @@
+#ifndef NETWORK_BUILDER_HPP
+#define NETWORK_BUILDER_HPP
+
+#include "NeuralNetwork.hpp"
+#include "ThreadPool.hpp"
+
+// WeightInit selects the standard deviation of the initial weights entering a layer
+enum class WeightInit {
+    Normal, // 1, like loadNetwork
+    Xavier, // sqrt(2 / (fanIn + fanOut))
+    He // sqrt(2 / fanIn)
+};
+
+// NetworkBuilder constructs fully connected networks in bulk.
+// Every node's adjacency map is reserved for its whole next layer up front, and the
+// weight from node i of layer l-1 to node j of layer l is the Philox sample keyed by
+// (seed, l, j * fanIn + i), so nodes can be filled in parallel and the result does not
+// depend on the number of threads.
+class NetworkBuilder {
+
+    public:
+        NetworkBuilder();
+
+        NetworkBuilder& addLayer(int numNodes, std::string activation);
+        NetworkBuilder& setSeed(uint64_t seed);
+        NetworkBuilder& setWeightInit(WeightInit init);
+
+        NeuralNetwork build() const;
+        NeuralNetwork build(ThreadPool& pool) const;
+
+    private:
+        void buildNode(NeuralNetwork& nn, int layer, int index) const; // creates a node and its outgoing connections
+
+        std::vector<int> layerSizes;
+        std::vector<std::string> activations;
+        std::vector<int> layerOffsets; // id of the first node of every layer
+        uint64_t seed;
+        WeightInit init;
+};
+
+#endif
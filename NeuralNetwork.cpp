@@ -1,5 +1,7 @@
 #include "NeuralNetwork.hpp"
 #include <queue>
+#include <iomanip>
+#include <limits>
 using namespace std;
 
 
@@ -9,12 +11,14 @@ NeuralNetwork::NeuralNetwork() : Graph(0) {
     learningRate = 0.1;
     evaluating = false;
     batchSize = 0;
+    inputsActiveAtZeroValid = false;
 }
 
 NeuralNetwork::NeuralNetwork(int size) : Graph(size) {
     learningRate = 0.1;
     evaluating = false;
     batchSize = 0;
+    inputsActiveAtZeroValid = false;
 }
 
 NeuralNetwork::NeuralNetwork(string filename) : Graph() {
@@ -29,6 +33,7 @@ NeuralNetwork::NeuralNetwork(string filename) : Graph() {
     learningRate = 0.1;
     evaluating = false;
     batchSize = 0;
+    inputsActiveAtZeroValid = false;
 
     fin.close();
 }
@@ -38,6 +43,7 @@ NeuralNetwork::NeuralNetwork(istream& in) : Graph() {
     learningRate = 0.1;
     evaluating = false;
     batchSize = 0;
+    inputsActiveAtZeroValid = false;
 }
 
 void NeuralNetwork::eval() {
@@ -52,14 +58,23 @@ void NeuralNetwork::setLearningRate(double lr) {
     learningRate = lr;
 }
 
+double NeuralNetwork::getLearningRate() const {
+    return learningRate;
+}
+
 void NeuralNetwork::setInputNodeIds(std::vector<int> inputNodeIds) {
     this->inputNodeIds = inputNodeIds;
+    inputsActiveAtZeroValid = false;
 }
 
 void NeuralNetwork::setOutputNodeIds(std::vector<int> outputNodeIds) {
     this->outputNodeIds = outputNodeIds;
 }
 
+void NeuralNetwork::setLayers(vector<vector<int> > layers) {
+    this->layers = layers;
+}
+
 vector<int> NeuralNetwork::getInputNodeIds() const {
     return inputNodeIds; 
 }
@@ -68,8 +83,16 @@ vector<int> NeuralNetwork::getOutputNodeIds() const {
     return outputNodeIds; 
 }
 
-vector<double> NeuralNetwork::predict(DataInstance instance) {
-    vector<double> input = instance.x;
+vector<vector<int> > NeuralNetwork::getLayers() const {
+    return layers;
+}
+
+vector<double> NeuralNetwork::predict(const DataInstance& instance) {
+    if (instance.sparse) {
+        return predictSparse(instance);
+    }
+
+    const vector<double>& input = instance.x;
 
     // error checking : size mismatch
     if (input.size() != inputNodeIds.size()) {
@@ -117,14 +140,108 @@ vector<double> NeuralNetwork::predict(DataInstance instance) {
     return output;
 }
 
+vector<double> NeuralNetwork::predictSparse(const DataInstance& instance) {
+    // error checking : feature index out of range
+    for (int i = 0; i < instance.indices.size(); i++) {
+        if (instance.indices[i] < 0 || instance.indices[i] >= inputNodeIds.size()) {
+            cerr << "input size mismatch." << endl;
+            cerr << "\tNeuralNet expected feature indices below: " << inputNodeIds.size() << endl;
+            cerr << "\tBut got: " << instance.indices[i] << endl;
+            return vector<double>();
+        }
+    }
+
+    // the scratch bitmap is allocated once and only the touched entries are reset afterwards,
+    // so the cost of this call scales with the nodes it reaches, not with the input width
+    if (sparseVisited.size() != size) {
+        sparseVisited.assign(size, false);
+    }
+
+    // inputs that are zero and stay zero after bias and activation contribute nothing, so only
+    // the non-zero inputs and the inputs that are active at zero are traversed
+    queue<int> nodeQueue;
+    vector<int> roots; // traversed input nodes, without duplicates
+    vector<int> touched; // every node whose values have to be flushed afterwards
+
+    const vector<int>& activeAtZero = getInputsActiveAtZero();
+    for (int i = 0; i < activeAtZero.size(); i++) {
+        roots.push_back(activeAtZero[i]);
+        sparseVisited[activeAtZero[i]] = true;
+    }
+    for (int i = 0; i < instance.indices.size(); i++) {
+        int id = inputNodeIds[instance.indices[i]];
+        nodes[id]->preActivationValue = instance.values[i];
+        if (!sparseVisited[id]) {
+            roots.push_back(id);
+            sparseVisited[id] = true;
+        }
+    }
+    if (roots.empty()) {
+        // an all zero instance still has to reach the nodes after the input layer
+        roots.push_back(inputNodeIds.at(0));
+        sparseVisited[roots.back()] = true;
+    }
+    for (int i = 0; i < roots.size(); i++) {
+        nodeQueue.push(roots[i]);
+    }
+
+    while(!nodeQueue.empty()) {
+        int curr = nodeQueue.front();
+        nodeQueue.pop();
+        touched.push_back(curr);
+        visitPredictNode(curr);
+        for (auto edge : adjacencyList[curr]) {
+            visitPredictNeighbor(edge.second);
+            if (!sparseVisited[edge.first]) {
+                sparseVisited[edge.first] = true;
+                nodeQueue.push(edge.first);
+            }
+        }
+    }
+    for (int i = 0; i < touched.size(); i++) {
+        sparseVisited[touched[i]] = false;
+    }
+
+    vector<double> output;
+    for (int i = 0; i < outputNodeIds.size(); i++) {
+        output.push_back(nodes.at(outputNodeIds.at(i))->postActivationValue);
+    }
+
+    if (!evaluating) {
+        batchSize++;
+        contribute(instance.y, output.at(0), roots); // accumulate derivates of the traversed connections only
+    }
+    flush(touched);
+    return output;
+}
+
+const vector<int>& NeuralNetwork::getInputsActiveAtZero() {
+    if (!inputsActiveAtZeroValid) {
+        inputsActiveAtZero.clear();
+        for (int i = 0; i < inputNodeIds.size(); i++) {
+            NodeInfo* n = nodes[inputNodeIds[i]];
+            if (n->activationFunction(n->bias) != 0) {
+                inputsActiveAtZero.push_back(inputNodeIds[i]);
+            }
+        }
+        inputsActiveAtZeroValid = true;
+    }
+    return inputsActiveAtZero;
+}
+
 bool NeuralNetwork::contribute(double y, double p) {
+    contribute(y, p, inputNodeIds);
+    flush();
+    return true;
+}
+
+bool NeuralNetwork::contribute(double y, double p, const vector<int>& sourceIds) {
     double incomingContribution = 0;
     double outgoingContribution = 0;
-    NodeInfo* currNode = nullptr;
 
-    for (int i = 0; i < inputNodeIds.size(); i++) {
-        currNode = nodes[i];
-        for (auto it = adjacencyList[i].begin(); it != adjacencyList[i].end(); it++) {
+    for (int i = 0; i < sourceIds.size(); i++) {
+        int s = sourceIds[i];
+        for (auto it = adjacencyList[s].begin(); it != adjacencyList[s].end(); it++) {
             int d = it->first;
             if (!contributions.count(d)) {
                 incomingContribution = contribute(d, y, p);
@@ -135,8 +252,6 @@ bool NeuralNetwork::contribute(double y, double p) {
             visitContributeNeighbor(it->second, incomingContribution, outgoingContribution);
         }
     }
-
-    flush();
     return true;
 }
 
@@ -169,6 +284,7 @@ double NeuralNetwork::contribute(int nodeId, const double& y, const double& p) {
 }
 
 bool NeuralNetwork::update() {
+    inputsActiveAtZeroValid = false;
     for (int id = 0; id < adjacencyList.size(); id++) {
         nodes[id]->bias -= (learningRate * nodes[id]->delta);
         nodes[id]->delta = 0;
@@ -181,6 +297,131 @@ bool NeuralNetwork::update() {
     return true;
 }
 
+vector<double> NeuralNetwork::getParameters() const {
+    vector<double> parameters;
+    for (int id = 0; id < adjacencyList.size(); id++) {
+        parameters.push_back(nodes[id]->bias);
+        for (auto it = adjacencyList[id].begin(); it != adjacencyList[id].end(); it++) {
+            parameters.push_back(it->second.weight);
+        }
+    }
+    return parameters;
+}
+
+void NeuralNetwork::setParameters(const vector<double>& parameters) {
+    inputsActiveAtZeroValid = false;
+    int k = 0;
+    for (int id = 0; id < adjacencyList.size(); id++) {
+        nodes[id]->bias = parameters.at(k++);
+        for (auto it = adjacencyList[id].begin(); it != adjacencyList[id].end(); it++) {
+            it->second.weight = parameters.at(k++);
+        }
+    }
+}
+
+vector<double> NeuralNetwork::getGradients() const {
+    vector<double> gradients;
+    for (int id = 0; id < adjacencyList.size(); id++) {
+        gradients.push_back(nodes[id]->delta);
+        for (auto it = adjacencyList[id].begin(); it != adjacencyList[id].end(); it++) {
+            gradients.push_back(it->second.delta);
+        }
+    }
+    return gradients;
+}
+
+void NeuralNetwork::setGradients(const vector<double>& gradients) {
+    int k = 0;
+    for (int id = 0; id < adjacencyList.size(); id++) {
+        nodes[id]->delta = gradients.at(k++);
+        for (auto it = adjacencyList[id].begin(); it != adjacencyList[id].end(); it++) {
+            it->second.delta = gradients.at(k++);
+        }
+    }
+}
+
+vector<vector<double> > NeuralNetwork::inputGradients(const vector<DataInstance>& batch, int outputIndex) const {
+    int batchLength = batch.size();
+    for (int b = 0; b < batchLength; b++) {
+        if (batch[b].sparse || batch[b].x.size() != inputNodeIds.size()) {
+            cerr << "input size mismatch." << endl;
+            cerr << "\tNeuralNet expected dense input size: " << inputNodeIds.size() << endl;
+            cerr << "\tBut got: " << batch[b].x.size() << endl;
+            return vector<vector<double> >();
+        }
+    }
+
+    // same breadth first order as predict; every node is visited after all of its sources
+    vector<int> order;
+    vector<bool> visited(size, false);
+    for (int i = 0; i < inputNodeIds.size(); i++) {
+        order.push_back(inputNodeIds[i]);
+        visited[inputNodeIds[i]] = true;
+    }
+    for (int k = 0; k < order.size(); k++) {
+        for (auto edge : adjacencyList[order[k]]) {
+            if (!visited[edge.first]) {
+                visited[edge.first] = true;
+                order.push_back(edge.first);
+            }
+        }
+    }
+
+    // forward: node values for the whole batch, kept outside the nodes
+    vector<vector<double> > z(size, vector<double>(batchLength, 0));
+    vector<vector<double> > a(size, vector<double>(batchLength, 0));
+    for (int i = 0; i < inputNodeIds.size(); i++) {
+        for (int b = 0; b < batchLength; b++) {
+            z[inputNodeIds[i]][b] = batch[b].x[i];
+        }
+    }
+    for (int k = 0; k < order.size(); k++) {
+        int v = order[k];
+        NodeInfo* n = nodes[v];
+        for (int b = 0; b < batchLength; b++) {
+            z[v][b] += n->bias;
+            a[v][b] = n->activationFunction(z[v][b]);
+        }
+        for (auto edge : adjacencyList[v]) {
+            double w = edge.second.weight;
+            for (int b = 0; b < batchLength; b++) {
+                z[edge.first][b] += a[v][b] * w;
+            }
+        }
+    }
+
+    // backward: like contribute, every node's incoming contribution is the weighted sum of its
+    // destinations' contributions times its own derivative, seeded with d(output)/d(output) = 1
+    int outputId = outputNodeIds.at(outputIndex);
+    vector<vector<double> > g(size, vector<double>(batchLength, 0));
+    for (int k = order.size() - 1; k >= 0; k--) {
+        int v = order[k];
+        if (v == outputId) {
+            g[v].assign(batchLength, 1);
+        } else {
+            for (auto edge : adjacencyList[v]) {
+                double w = edge.second.weight;
+                for (int b = 0; b < batchLength; b++) {
+                    g[v][b] += w * g[edge.first][b];
+                }
+            }
+        }
+        FuncSig derivative = nodes[v]->activationDerivative;
+        for (int b = 0; b < batchLength; b++) {
+            g[v][b] *= derivative(z[v][b]);
+        }
+    }
+
+    // an input node's pre activation value is its feature plus a bias, so its contribution is the gradient
+    vector<vector<double> > gradients(batchLength, vector<double>(inputNodeIds.size()));
+    for (int b = 0; b < batchLength; b++) {
+        for (int i = 0; i < inputNodeIds.size(); i++) {
+            gradients[b][i] = g[inputNodeIds[i]][b];
+        }
+    }
+    return gradients;
+}
+
 void NeuralNetwork::loadNetwork(istream& in) {
     int numLayers(0), totalNodes(0), numNodes(0), weightModifications(0), biasModifications(0); string activationMethod = "identity";
     string junk;
@@ -271,6 +512,15 @@ void NeuralNetwork::visitContributeNeighbor(Connection& c, double& incomingContr
     c.delta += incomingContribution * v->postActivationValue;
 }
 
+void NeuralNetwork::flush(const vector<int>& touched) {
+    for (int i = 0; i < touched.size(); i++) {
+        nodes.at(touched[i])->postActivationValue = 0;
+        nodes.at(touched[i])->preActivationValue = 0;
+    }
+    contributions.clear();
+    batchSize = 0;
+}
+
 void NeuralNetwork::flush() {
     for (int i = 0; i < nodes.size(); i++) {
         nodes.at(i)->postActivationValue = 0;
@@ -285,14 +535,23 @@ double NeuralNetwork::assess(string filename) {
     return assess(dl);
 }
 
-double NeuralNetwork::assess(DataLoader dl) {
+double NeuralNetwork::assess(const DataLoader& dl) {
+    return assess(dl.getData());
+}
+
+double NeuralNetwork::assess(const vector<DataInstance>& data) {
+    if (data.empty()) {
+        cerr << "Cannot assess accuracy on an empty dataset" << endl;
+        exit(1);
+    }
+
     bool stateBefore = evaluating;
     evaluating = true;
     double count(0);
     double correct(0);
     vector<double> output;
-    for (int i = 0; i < dl.getData().size(); i++) {
-        DataInstance di = dl.getData().at(i);
+    for (int i = 0; i < data.size(); i++) {
+        const DataInstance& di = data.at(i);
         output = predict(di);
         if (static_cast<int>(round(output.at(0))) == di.y) {
             correct++;
@@ -300,10 +559,6 @@ double NeuralNetwork::assess(DataLoader dl) {
         count++;
     }
 
-    if (dl.getData().empty()) {
-        cerr << "Cannot assess accuracy on an empty dataset" << endl;
-        exit(1);
-    }
     evaluating = stateBefore;
     return correct / count;
 }
@@ -311,7 +566,9 @@ double NeuralNetwork::assess(DataLoader dl) {
 
 void NeuralNetwork::saveModel(string filename) {
     ofstream fout(filename);
-    
+    // enough digits that loading the model gives back exactly the same weights
+    fout << setprecision(numeric_limits<double>::max_digits10);
+
     fout << layers.size() << " " << getNodes().size() << endl;
     for (int i = 0; i < layers.size(); i++) {
         NodeInfo* layerNode = getNodes().at(layers.at(i).at(0));
@@ -324,6 +581,8 @@ void NeuralNetwork::saveModel(string filename) {
     int numBias = 0;
     stringstream weightStream;
     stringstream biasStream;
+    weightStream << setprecision(numeric_limits<double>::max_digits10);
+    biasStream << setprecision(numeric_limits<double>::max_digits10);
     for (int i = 0; i < nodes.size(); i++) {
         numBias++;
         biasStream << i << " " << nodes.at(i)->bias << endl;
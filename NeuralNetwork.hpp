@@ -16,21 +16,42 @@ class NeuralNetwork : public Graph {
         void eval(); // puts the neural network in eval mode, no gradients accumulated
         void train(); // puts the neural network in train mode, gradients accumulated
         void setLearningRate(double lr);
+        double getLearningRate() const;
         void setInputNodeIds(std::vector<int> inputNodeIds);
         void setOutputNodeIds(std::vector<int> outputNodeIds);
+        void setLayers(std::vector<std::vector<int> > layers);
         std::vector<int> getInputNodeIds() const;
         std::vector<int> getOutputNodeIds() const;
+        std::vector<std::vector<int> > getLayers() const;
 
-        std::vector<double> predict(DataInstance instance); // computes predicted values
+        std::vector<double> predict(const DataInstance& instance); // computes predicted values
         bool update(); // apply accumumated gradients and update weights and biases
 
-        double assess(DataLoader dl); // calculates neural networks accuracy
+        // d(output outputIndex) / d(feature) for every feature of every dense instance in batch, from one
+        // batched forward and one batched backward traversal; no node values or deltas are modified
+        std::vector<std::vector<double> > inputGradients(const std::vector<DataInstance>& batch, int outputIndex = 0) const;
+
+        // parameters and accumulated gradients flattened as each node's bias followed by its outgoing weights,
+        // in node id order; replicas built from the same model file share the same order
+        std::vector<double> getParameters() const;
+        void setParameters(const std::vector<double>& parameters);
+        std::vector<double> getGradients() const;
+        void setGradients(const std::vector<double>& gradients);
+
+        double assess(const std::vector<DataInstance>& data); // calculates neural networks accuracy
+        double assess(const DataLoader& dl); // calculates neural networks accuracy
         double assess(std::string filename); // calculates neural networks accuracy
         void saveModel(std::string filename); // saves the model
         friend std::ostream& operator<<(std::ostream& out, const NeuralNetwork& nn);
 
     private:
+        friend class NetworkBuilder;
+
+        std::vector<double> predictSparse(const DataInstance& instance); // predict touching only non-zero inputs
+        const std::vector<int>& getInputsActiveAtZero(); // input nodes whose activation is non-zero for a zero input
+
         bool contribute(double y, double p);
+        bool contribute(double y, double p, const std::vector<int>& sourceIds); // only accumulates from the given input nodes
         double contribute(int nodeId, const double& y, const double& p); // contribute helper function
 
         void visitPredictNode(int vId); // visits the node during evaluation
@@ -45,9 +66,13 @@ class NeuralNetwork : public Graph {
         std::unordered_map<int, double> contributions; // keeps track of which contributions have already been made
         std::vector<int> inputNodeIds;
         std::vector<int> outputNodeIds;
-        
+        std::vector<int> inputsActiveAtZero;
+        bool inputsActiveAtZeroValid; // cleared whenever input biases may have changed
+        std::vector<bool> sparseVisited; // predictSparse's scratch bitmap, all false between calls
+
         void loadNetwork(std::istream& in); // loads neural network structure from the input file stream
         void flush(); // refreshes node values for the next computation
+        void flush(const std::vector<int>& touched); // refreshes only the given nodes
 };
 
 #endif
\ No newline at end of file
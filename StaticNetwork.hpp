@@ -0,0 +1,267 @@
+#ifndef STATIC_NETWORK_HPP
+#define STATIC_NETWORK_HPP
+
+#include "NeuralNetwork.hpp"
+#include <array>
+#include <cmath>
+
+// Activation selects a layer's activation function at compile time
+enum class Activation { Identity, ReLU, Sigmoid };
+
+// Layer describes one layer of a StaticNetwork: its number of nodes and activation
+template <int Size, Activation Act = Activation::Sigmoid>
+struct Layer {
+    static_assert(Size > 0, "Layer must have at least one node");
+    static constexpr int size = Size;
+    static constexpr Activation activation = Act;
+};
+
+// StaticNetwork is a fully connected network whose shape is fixed at compile time,
+// e.g. StaticNetwork<Layer<8, Activation::Identity>, Layer<3>, Layer<5>, Layer<1> >.
+// All parameters and node values live in std::arrays inside the object, so there is
+// no heap allocation and the compiler sees every loop bound.
+// It follows the same conventions as NeuralNetwork: the input layer adds its bias and
+// applies its activation, backward accumulates the derivatives that contribute would,
+// and update applies them with the learning rate.
+template <typename... Layers>
+class StaticNetwork {
+
+    public:
+        static constexpr int numLayers = sizeof...(Layers);
+        static_assert(numLayers >= 2, "StaticNetwork must have at least 2 layers");
+
+        static constexpr std::array<int, numLayers> sizes = {Layers::size...};
+        static constexpr std::array<Activation, numLayers> activations = {Layers::activation...};
+        static constexpr int numNodes = (Layers::size + ...);
+        static constexpr int inputSize = sizes[0];
+        static constexpr int outputSize = sizes[numLayers - 1];
+
+    private:
+        // index of the first node of each layer
+        static constexpr std::array<int, numLayers> computeNodeOffsets() {
+            std::array<int, numLayers> offsets = {};
+            for (int l = 1; l < numLayers; l++) {
+                offsets[l] = offsets[l-1] + sizes[l-1];
+            }
+            return offsets;
+        }
+
+        // index of the first weight entering each layer, stored as [dest][source]
+        static constexpr std::array<int, numLayers + 1> computeWeightOffsets() {
+            std::array<int, numLayers + 1> offsets = {};
+            for (int l = 1; l < numLayers; l++) {
+                offsets[l+1] = offsets[l] + sizes[l-1] * sizes[l];
+            }
+            return offsets;
+        }
+
+    public:
+        static constexpr std::array<int, numLayers> nodeOffsets = computeNodeOffsets();
+        static constexpr std::array<int, numLayers + 1> weightOffsets = computeWeightOffsets();
+        static constexpr int numWeights = weightOffsets[numLayers];
+
+        StaticNetwork() : weights{}, weightDeltas{}, biases{}, biasDeltas{}, z{}, a{} {
+            learningRate = 0.1;
+        }
+
+        void setLearningRate(double lr) {
+            learningRate = lr;
+        }
+
+        // weight of the connection from node i of layer l-1 to node j of layer l
+        double& weight(int l, int j, int i) {
+            return weights[weightOffsets[l] + j * sizes[l-1] + i];
+        }
+
+        double weight(int l, int j, int i) const {
+            return weights[weightOffsets[l] + j * sizes[l-1] + i];
+        }
+
+        // bias of node j of layer l
+        double& bias(int l, int j) {
+            return biases[nodeOffsets[l] + j];
+        }
+
+        double bias(int l, int j) const {
+            return biases[nodeOffsets[l] + j];
+        }
+
+        // computes predicted values, keeping node values for a following backward
+        std::array<double, outputSize> forward(const std::array<double, inputSize>& x) {
+            for (int i = 0; i < inputSize; i++) {
+                z[i] = x[i] + biases[i];
+                a[i] = activate(activations[0], z[i]);
+            }
+
+            for (int l = 1; l < numLayers; l++) {
+                const double* w = &weights[weightOffsets[l]];
+                const double* prev = &a[nodeOffsets[l-1]];
+                for (int j = 0; j < sizes[l]; j++) {
+                    double sum = 0;
+                    for (int i = 0; i < sizes[l-1]; i++) {
+                        sum += prev[i] * w[j * sizes[l-1] + i];
+                    }
+                    int node = nodeOffsets[l] + j;
+                    z[node] = sum + biases[node];
+                    a[node] = activate(activations[l], z[node]);
+                }
+            }
+
+            std::array<double, outputSize> output;
+            for (int j = 0; j < outputSize; j++) {
+                output[j] = a[nodeOffsets[numLayers-1] + j];
+            }
+            return output;
+        }
+
+        // accumulates derivatives of the last forward pass for label y
+        void backward(double y) {
+            std::array<double, numNodes> g;
+            double p = a[nodeOffsets[numLayers-1]];
+
+            // every output node is seeded from the first output, as in NeuralNetwork::contribute
+            for (int j = 0; j < outputSize; j++) {
+                int node = nodeOffsets[numLayers-1] + j;
+                g[node] = -1 * ((y - p) / (p * (1 - p))) * derive(activations[numLayers-1], z[node]);
+                biasDeltas[node] += g[node];
+            }
+
+            for (int l = numLayers - 1; l >= 1; l--) {
+                const double* w = &weights[weightOffsets[l]];
+                double* wd = &weightDeltas[weightOffsets[l]];
+                const double* prev = &a[nodeOffsets[l-1]];
+                const double* next = &g[nodeOffsets[l]];
+
+                for (int j = 0; j < sizes[l]; j++) {
+                    for (int i = 0; i < sizes[l-1]; i++) {
+                        wd[j * sizes[l-1] + i] += next[j] * prev[i];
+                    }
+                }
+
+                // the input layer's bias receives no gradient, matching NeuralNetwork
+                if (l == 1) break;
+
+                for (int i = 0; i < sizes[l-1]; i++) {
+                    double sum = 0;
+                    for (int j = 0; j < sizes[l]; j++) {
+                        sum += w[j * sizes[l-1] + i] * next[j];
+                    }
+                    int node = nodeOffsets[l-1] + i;
+                    g[node] = sum * derive(activations[l-1], z[node]);
+                    biasDeltas[node] += g[node];
+                }
+            }
+        }
+
+        // apply accumulated gradients and update weights and biases
+        void update() {
+            for (int k = 0; k < numWeights; k++) {
+                weights[k] -= learningRate * weightDeltas[k];
+                weightDeltas[k] = 0;
+            }
+            for (int k = 0; k < numNodes; k++) {
+                biases[k] -= learningRate * biasDeltas[k];
+                biasDeltas[k] = 0;
+            }
+        }
+
+        // copies the parameters of a NeuralNetwork with the same layer sizes and activations
+        static StaticNetwork fromNeuralNetwork(const NeuralNetwork& nn) {
+            std::vector<std::vector<int> > layers = nn.getLayers();
+            const AdjList& adjacencyList = nn.getAdjacencyList();
+
+            if (layers.size() != numLayers) {
+                std::cerr << "StaticNetwork expected " << numLayers << " layers, but got " << layers.size() << " layers" << std::endl;
+                exit(1);
+            }
+
+            StaticNetwork sn;
+            for (int l = 0; l < numLayers; l++) {
+                if (layers[l].size() != sizes[l]) {
+                    std::cerr << "StaticNetwork expected layer " << l << " to have " << sizes[l] << " nodes, but got " << layers[l].size() << std::endl;
+                    exit(1);
+                }
+                for (int j = 0; j < sizes[l]; j++) {
+                    NodeInfo* node = nn.getNode(layers[l][j]);
+                    if (node->activationFunction != getActivationFunction(identifier(activations[l]))) {
+                        std::cerr << "StaticNetwork expected layer " << l << " to use " << identifier(activations[l])
+                                  << " activation, but got " << getActivationIdentifier(node->activationFunction) << std::endl;
+                        exit(1);
+                    }
+                    sn.bias(l, j) = node->bias;
+
+                    if (l == 0) continue;
+                    for (int i = 0; i < sizes[l-1]; i++) {
+                        auto edge = adjacencyList[layers[l-1][i]].find(layers[l][j]);
+                        sn.weight(l, j, i) = (edge == adjacencyList[layers[l-1][i]].end()) ? 0 : edge->second.weight;
+                    }
+                }
+            }
+            sn.setLearningRate(nn.getLearningRate());
+            return sn;
+        }
+
+        // builds an equivalent NeuralNetwork, numbering nodes layer by layer like loadNetwork
+        NeuralNetwork toNeuralNetwork() const {
+            NeuralNetwork nn(numNodes);
+            std::vector<std::vector<int> > layers(numLayers);
+
+            for (int l = 0; l < numLayers; l++) {
+                for (int j = 0; j < sizes[l]; j++) {
+                    int id = nodeOffsets[l] + j;
+                    nn.updateNode(id, NodeInfo(identifier(activations[l]), 0, bias(l, j)));
+                    layers[l].push_back(id);
+
+                    if (l == 0) continue;
+                    for (int i = 0; i < sizes[l-1]; i++) {
+                        nn.updateConnection(layers[l-1][i], id, weight(l, j, i));
+                    }
+                }
+            }
+
+            nn.setLayers(layers);
+            nn.setInputNodeIds(layers.front());
+            nn.setOutputNodeIds(layers.back());
+            nn.setLearningRate(learningRate);
+            return nn;
+        }
+
+    private:
+        static std::string identifier(Activation act) {
+            if (act == Activation::ReLU) {
+                return "ReLU";
+            } else if (act == Activation::Sigmoid) {
+                return "sigmoid";
+            }
+            return "identity";
+        }
+
+        static double activate(Activation act, double x) {
+            if (act == Activation::ReLU) {
+                return (x >= 0) ? x : 0;
+            } else if (act == Activation::Sigmoid) {
+                return 1 / (1 + std::exp(-x));
+            }
+            return x;
+        }
+
+        static double derive(Activation act, double x) {
+            if (act == Activation::ReLU) {
+                return (x > 0) ? 1.0 : 0.0;
+            } else if (act == Activation::Sigmoid) {
+                double s = 1 / (1 + std::exp(-x));
+                return s * (1 - s);
+            }
+            return 1;
+        }
+
+        std::array<double, numWeights> weights;
+        std::array<double, numWeights> weightDeltas; // accumulated derivative for each weight
+        std::array<double, numNodes> biases;
+        std::array<double, numNodes> biasDeltas; // accumulated derivative for each bias
+        std::array<double, numNodes> z; // pre activation node values
+        std::array<double, numNodes> a; // post activation node values
+        double learningRate;
+};
+
+#endif
@@ -0,0 +1,131 @@
+#include "Sweep.hpp"
+#include "NetworkBuilder.hpp"
+#include <algorithm>
+using namespace std;
+
+// SweepConfig -----------------------------------------------------------------------------------------------------------------------------------
+
+SweepConfig::SweepConfig(double learningRate, vector<int> hiddenWidths) {
+    this->learningRate = learningRate;
+    this->hiddenWidths = hiddenWidths;
+}
+
+string SweepConfig::describe() const {
+    string shape;
+    for (int i = 0; i < hiddenWidths.size(); i++) {
+        shape += to_string(hiddenWidths.at(i)) + "-";
+    }
+    return shape + "1";
+}
+
+// SweepResult -----------------------------------------------------------------------------------------------------------------------------------
+
+SweepResult::SweepResult(SweepConfig config) : config(config) {
+    epochs = 0;
+    accuracy = 0;
+    rung = 0;
+    seed = 0;
+}
+
+// Sweep -----------------------------------------------------------------------------------------------------------------------------------
+
+Sweep::Sweep(const vector<DataInstance>& trainData, const vector<DataInstance>& validationData, int numThreads)
+    : trainData(trainData), validationData(validationData), pool(numThreads) {
+    if (trainData.empty() || validationData.empty()) {
+        cerr << "Sweep needs non-empty training and validation data" << endl;
+        exit(1);
+    }
+}
+
+NeuralNetwork Sweep::buildNetwork(const SweepConfig& config, uint64_t seed) {
+    NetworkBuilder builder;
+    builder.addLayer(trainData.at(0).x.size(), "identity");
+    for (int i = 0; i < config.hiddenWidths.size(); i++) {
+        builder.addLayer(config.hiddenWidths.at(i), "sigmoid");
+    }
+    builder.addLayer(1, "sigmoid");
+    builder.setSeed(seed);
+
+    NeuralNetwork nn = builder.build(pool);
+    nn.setLearningRate(config.learningRate);
+    return nn;
+}
+
+void Sweep::trainEpochs(NeuralNetwork& nn, int numEpochs) const {
+    nn.train();
+    for (int i = 0; i < numEpochs; i++) {
+        for (size_t j = 0; j < trainData.size(); j++) {
+            nn.predict(trainData[j]);
+        }
+        nn.update();
+    }
+}
+
+vector<SweepResult> Sweep::run(const vector<SweepConfig>& configs, int minEpochs, int maxEpochs, int eta) {
+    vector<SweepResult> results;
+    vector<NeuralNetwork> networks;
+    networks.reserve(configs.size());
+
+    for (int i = 0; i < configs.size(); i++) {
+        results.push_back(SweepResult(configs.at(i)));
+        results.back().seed = i + 1;
+        networks.push_back(buildNetwork(configs.at(i), results.back().seed));
+    }
+
+    vector<int> alive(configs.size());
+    for (int i = 0; i < alive.size(); i++) {
+        alive[i] = i;
+    }
+
+    eta = max(2, eta);
+    int budget = max(1, minEpochs);
+    for (int rung = 0; !alive.empty(); rung++) {
+        // train every surviving configuration up to this rung's budget
+        pool.parallelFor(0, alive.size(), [&](int k) {
+            int id = alive[k];
+            trainEpochs(networks[id], budget - results[id].epochs);
+            results[id].epochs = budget;
+            results[id].accuracy = networks[id].assess(validationData);
+            results[id].rung = rung;
+        });
+
+        if (alive.size() == 1 || budget >= maxEpochs) {
+            break;
+        }
+
+        // keep the best 1/eta of the configurations for the next rung
+        stable_sort(alive.begin(), alive.end(), [&](int a, int b) {
+            return results[a].accuracy > results[b].accuracy;
+        });
+        alive.resize((alive.size() + eta - 1) / eta);
+        budget = min(maxEpochs, budget * eta);
+    }
+
+    stable_sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b) {
+        if (a.rung != b.rung) return a.rung > b.rung;
+        return a.accuracy > b.accuracy;
+    });
+    return results;
+}
+
+NeuralNetwork Sweep::retrain(const SweepResult& result) {
+    NeuralNetwork nn = buildNetwork(result.config, result.seed);
+    trainEpochs(nn, result.epochs);
+    return nn;
+}
+
+void Sweep::writeResults(const vector<SweepResult>& results, string filename) {
+    ofstream fout(filename);
+
+    if (fout.fail()) {
+        cerr << "Could not open " << filename << " for writing. " << endl;
+        exit(1);
+    }
+
+    fout << "shape,learning_rate,epochs,rung,accuracy" << endl;
+    for (int i = 0; i < results.size(); i++) {
+        const SweepResult& r = results.at(i);
+        fout << r.config.describe() << "," << r.config.learningRate << "," << r.epochs << "," << r.rung << "," << r.accuracy << endl;
+    }
+    fout.close();
+}
@@ -0,0 +1,48 @@
+#ifndef SWEEP_HPP
+#define SWEEP_HPP
+
+#include "NeuralNetwork.hpp"
+#include "ThreadPool.hpp"
+
+// SweepConfig is one point of a hyperparameter search
+struct SweepConfig {
+    SweepConfig(double learningRate, std::vector<int> hiddenWidths);
+    double learningRate;
+    std::vector<int> hiddenWidths; // sizes of the sigmoid hidden layers between input and output
+
+    std::string describe() const; // hidden and output layer sizes, e.g. "3-5-1"
+};
+
+// SweepResult records how far a configuration got in the search
+struct SweepResult {
+    SweepResult(SweepConfig config);
+    SweepConfig config;
+    int epochs; // epochs trained before it was stopped or finished
+    double accuracy; // validation accuracy after the last epoch trained
+    int rung; // last successive halving rung the configuration took part in
+    uint64_t seed; // initialized the configuration's network
+};
+
+// Sweep trains many NeuralNetwork replicas concurrently against one shared, read-only
+// training and validation set and prunes them with successive halving: after every rung
+// only the best 1/eta of the configurations continue, with eta times the epoch budget.
+class Sweep {
+
+    public:
+        Sweep(const std::vector<DataInstance>& trainData, const std::vector<DataInstance>& validationData, int numThreads);
+
+        std::vector<SweepResult> run(const std::vector<SweepConfig>& configs, int minEpochs, int maxEpochs, int eta);
+        // rebuilds the network a result describes, trained for the same epochs on the same data
+        NeuralNetwork retrain(const SweepResult& result);
+        static void writeResults(const std::vector<SweepResult>& results, std::string filename);
+
+    private:
+        NeuralNetwork buildNetwork(const SweepConfig& config, uint64_t seed);
+        void trainEpochs(NeuralNetwork& nn, int numEpochs) const;
+
+        const std::vector<DataInstance>& trainData;
+        const std::vector<DataInstance>& validationData;
+        ThreadPool pool;
+};
+
+#endif
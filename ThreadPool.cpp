@@ -0,0 +1,129 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+using namespace std;
+
+// index of the pool thread running the current task, -1 outside the pool
+static thread_local int currentWorker = -1;
+static thread_local const ThreadPool* currentPool = nullptr;
+
+ThreadPool::ThreadPool(int numThreads) {
+    queued = 0;
+    pending = 0;
+    nextQueue = 0;
+    stopping = false;
+
+    numThreads = max(1, numThreads);
+    for (int i = 0; i < numThreads; i++) {
+        queues.push_back(unique_ptr<TaskQueue>(new TaskQueue()));
+    }
+    for (int i = 0; i < numThreads; i++) {
+        threads.push_back(thread(&ThreadPool::run, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    wait();
+    {
+        lock_guard<mutex> guard(stateLock);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (int i = 0; i < threads.size(); i++) {
+        threads[i].join();
+    }
+}
+
+int ThreadPool::getNumThreads() const {
+    return threads.size();
+}
+
+void ThreadPool::submit(function<void()> task) {
+    int target;
+    {
+        lock_guard<mutex> guard(stateLock);
+        pending++;
+        target = (currentPool == this) ? currentWorker : nextQueue++ % queues.size();
+    }
+    {
+        lock_guard<mutex> guard(queues[target]->lock);
+        queues[target]->tasks.push_back(task);
+    }
+    {
+        lock_guard<mutex> guard(stateLock);
+        queued++;
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::wait() {
+    unique_lock<mutex> guard(stateLock);
+    allDone.wait(guard, [this]() { return pending == 0; });
+}
+
+void ThreadPool::parallelFor(int begin, int end, function<void(int)> body) {
+    // a few chunks per thread leaves room for stealing when iterations are uneven
+    int numChunks = min(end - begin, 4 * getNumThreads());
+    for (int c = 0; c < numChunks; c++) {
+        int chunkBegin = begin + (long long)(end - begin) * c / numChunks;
+        int chunkEnd = begin + (long long)(end - begin) * (c + 1) / numChunks;
+        submit([chunkBegin, chunkEnd, &body]() {
+            for (int i = chunkBegin; i < chunkEnd; i++) {
+                body(i);
+            }
+        });
+    }
+    wait();
+}
+
+bool ThreadPool::take(int id, function<void()>& task) {
+    {
+        lock_guard<mutex> guard(queues[id]->lock);
+        if (!queues[id]->tasks.empty()) {
+            task = queues[id]->tasks.back();
+            queues[id]->tasks.pop_back();
+            return true;
+        }
+    }
+
+    for (int k = 1; k < queues.size(); k++) {
+        TaskQueue& victim = *queues[(id + k) % queues.size()];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(int id) {
+    currentWorker = id;
+    currentPool = this;
+
+    while (true) {
+        {
+            unique_lock<mutex> guard(stateLock);
+            taskAvailable.wait(guard, [this]() { return queued > 0 || stopping; });
+            if (queued == 0 && stopping) {
+                return;
+            }
+            // claiming a task here guarantees one is left in some deque for this thread
+            queued--;
+        }
+
+        function<void()> task;
+        while (!take(id, task)) {
+            this_thread::yield();
+        }
+        task();
+
+        {
+            lock_guard<mutex> guard(stateLock);
+            pending--;
+            if (pending == 0) {
+                allDone.notify_all();
+            }
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// ThreadPool runs tasks on a fixed set of threads.
+// Every thread owns a deque of tasks: it takes work from the back of its own deque
+// and, once that is empty, steals from the front of the other threads' deques.
+class ThreadPool {
+
+    public:
+        ThreadPool(int numThreads);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+
+        int getNumThreads() const;
+
+        // queues a task; tasks submitted from a pool thread go to that thread's own deque
+        void submit(std::function<void()> task);
+        // blocks until every submitted task has finished, must not be called from a task
+        void wait();
+        // runs body(i) for every i in [begin, end) and waits for all of them
+        void parallelFor(int begin, int end, std::function<void(int)> body);
+
+    private:
+        struct TaskQueue {
+            std::deque<std::function<void()> > tasks;
+            std::mutex lock;
+        };
+
+        void run(int id); // loop executed by every pool thread
+        bool take(int id, std::function<void()>& task); // pops own work first, then steals
+
+        std::vector<std::unique_ptr<TaskQueue> > queues;
+        std::vector<std::thread> threads;
+
+        std::mutex stateLock;
+        std::condition_variable taskAvailable;
+        std::condition_variable allDone;
+        int queued; // tasks waiting in some deque and not yet claimed by a thread
+        int pending; // tasks submitted but not yet finished
+        int nextQueue; // round robin target for tasks submitted from outside the pool
+        bool stopping;
+};
+
+#endif
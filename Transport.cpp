@@ -0,0 +1,116 @@
+#include "Transport.hpp"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+// Transport -----------------------------------------------------------------------------------------------------------------------------------
+
+Transport::Transport(int rank, int numWorkers) {
+    this->rank = rank;
+    this->numWorkers = numWorkers;
+}
+
+Transport::~Transport() {}
+
+int Transport::getRank() const {
+    return rank;
+}
+
+int Transport::getNumWorkers() const {
+    return numWorkers;
+}
+
+// SharedMemoryTransport -----------------------------------------------------------------------------------------------------------------------------------
+
+size_t SharedMemoryTransport::segmentSize(int numWorkers, int length) {
+    return sizeof(Header) + sizeof(double) * numWorkers * length;
+}
+
+void SharedMemoryTransport::create(string name, int numWorkers, int length) {
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        cerr << "Could not create shared memory segment " << name << ": " << strerror(errno) << endl;
+        exit(1);
+    }
+
+    size_t size = segmentSize(numWorkers, length);
+    if (ftruncate(fd, size) != 0) {
+        cerr << "Could not size shared memory segment " << name << ": " << strerror(errno) << endl;
+        exit(1);
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        cerr << "Could not map shared memory segment " << name << ": " << strerror(errno) << endl;
+        exit(1);
+    }
+
+    // the barrier lives in the segment so that every worker process waits on the same one
+    Header* header = static_cast<Header*>(mapping);
+    pthread_barrierattr_t attr;
+    pthread_barrierattr_init(&attr);
+    pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(&header->barrier, &attr, numWorkers);
+    pthread_barrierattr_destroy(&attr);
+
+    munmap(mapping, size);
+}
+
+void SharedMemoryTransport::destroy(string name) {
+    shm_unlink(name.c_str());
+}
+
+SharedMemoryTransport::SharedMemoryTransport(string name, int rank, int numWorkers, int length) : Transport(rank, numWorkers) {
+    this->length = length;
+    this->size = segmentSize(numWorkers, length);
+
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        cerr << "Could not open shared memory segment " << name << ": " << strerror(errno) << endl;
+        _exit(1);
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        cerr << "Could not map shared memory segment " << name << ": " << strerror(errno) << endl;
+        _exit(1);
+    }
+
+    header = static_cast<Header*>(mapping);
+    slots = reinterpret_cast<double*>(static_cast<char*>(mapping) + sizeof(Header));
+}
+
+SharedMemoryTransport::~SharedMemoryTransport() {
+    munmap(header, size);
+}
+
+void SharedMemoryTransport::allreduce(vector<double>& buffer) {
+    if (buffer.size() != length) {
+        cerr << "allreduce size mismatch." << endl;
+        cerr << "\tTransport expected buffer size: " << length << endl;
+        cerr << "\tBut got: " << buffer.size() << endl;
+        _exit(1);
+    }
+
+    memcpy(slots + rank * length, buffer.data(), sizeof(double) * length);
+    pthread_barrier_wait(&header->barrier);
+
+    // every worker sums the slots in rank order, so all workers get bit-identical results
+    for (int i = 0; i < length; i++) {
+        double sum = 0;
+        for (int r = 0; r < numWorkers; r++) {
+            sum += slots[r * length + i];
+        }
+        buffer[i] = sum;
+    }
+
+    // nobody may overwrite its slot until everyone has finished reading
+    pthread_barrier_wait(&header->barrier);
+}
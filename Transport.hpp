@@ -0,0 +1,57 @@
+#ifndef TRANSPORT_HPP
+#define TRANSPORT_HPP
+
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+// Transport is the communication layer between data parallel training workers.
+// Implementations only need to provide an allreduce; every worker calls it with
+// a buffer of the same length and receives the element-wise sum over all workers.
+class Transport {
+
+    public:
+        Transport(int rank, int numWorkers);
+        virtual ~Transport();
+
+        int getRank() const;
+        int getNumWorkers() const;
+
+        // replaces buffer with the element-wise sum of every worker's buffer
+        virtual void allreduce(std::vector<double>& buffer) = 0;
+
+    protected:
+        int rank;
+        int numWorkers;
+};
+
+// SharedMemoryTransport exchanges buffers through a POSIX shared memory segment on one machine.
+// The launcher creates the segment, then each worker process attaches to it by name.
+// Errors after attaching end only the worker, with _exit, and are left for the launcher to detect.
+class SharedMemoryTransport : public Transport {
+
+    public:
+        // creates the named segment sized for numWorkers buffers of the given length
+        static void create(std::string name, int numWorkers, int length);
+        // removes the named segment once all workers are done
+        static void destroy(std::string name);
+
+        SharedMemoryTransport(std::string name, int rank, int numWorkers, int length);
+        ~SharedMemoryTransport();
+
+        void allreduce(std::vector<double>& buffer) override;
+
+    private:
+        struct Header {
+            pthread_barrier_t barrier;
+        };
+
+        static size_t segmentSize(int numWorkers, int length);
+
+        int length; // number of doubles per worker
+        size_t size; // size of the mapping in bytes
+        Header* header;
+        double* slots; // one buffer per worker, numWorkers * length doubles
+};
+
+#endif
@@ -0,0 +1,15 @@
+#include <iostream>
+#include "CodeGenerator.hpp"
+using namespace std;
+
+// usage: ./codegen <model file> <output header> [namespace]
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "usage: " << argv[0] << " <model file> <output header> [namespace]" << endl;
+        return 1;
+    }
+
+    string nameSpace = (argc > 3) ? argv[3] : "model";
+    generateScorer(argv[1], argv[2], nameSpace);
+    return 0;
+}
@@ -2,12 +2,78 @@
 #include "NeuralNetwork.hpp"
 #include "utility.hpp"
 #include "DataLoader.hpp"
+#include "DataParallel.hpp"
+#include "Sweep.hpp"
+#include "CrossValidation.hpp"
+#include "NetworkBuilder.hpp"
+#include "ModelHandle.hpp"
+#include "EarlyStopping.hpp"
+#include "MappedModel.hpp"
+#include "GraphOptimizer.hpp"
+#include "HogwildTrainer.hpp"
+#include "Ensemble.hpp"
+#include <unistd.h>
+#include <sys/wait.h>
+#include <chrono>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
 using namespace std;
 
 void testTrain(string networkFile, string trainFile, string testFile);
+void testDistributedTrain(string networkFile, string trainFile, string testFile, int numWorkers);
+void testSweep(string trainFile, string testFile, int numThreads);
+void testCrossValidation(string networkFile, string dataFile, int k, bool stratified, int numThreads);
+void testBuild(vector<int> layerSizes, int numThreads);
+void testServe(string networkFile, string trainFile, string testFile, int numReaders);
+void testEarlyStopping(string networkFile, string trainFile, string testFile);
+void testMapped(string networkFile, string binaryFile, string testFile, int numWorkers);
+void testOptimize(string networkFile, string trainFile, string testFile, string outputFile);
+void testExplain(string networkFile, string trainFile, string testFile, int numInstances);
+void testHogwild(string networkFile, string trainFile, string testFile, int maxThreads);
+void testEnsemble(string trainFile, string testFile, int numMembers);
+void holdOut(const vector<DataInstance>& data, int k, vector<DataInstance>& train, vector<DataInstance>& validation);
 
+// usage: ./neuralnet [train | distributed <workers> | sweep <threads> | cv <k> [stratified] | build <threads> | serve <readers> | early | mapped <workers> | optimize <output model> | explain <instances> | hogwild <threads> | ensemble <members>]
 int main(int argc, char* argv[]) {
-    testTrain("./models/diabetes.init", "./data/diabetes_train.csv", "./data/diabetes_test.csv");
+    string mode = (argc > 1) ? argv[1] : "train";
+
+    if (mode == "distributed") {
+        int numWorkers = (argc > 2) ? stoi(argv[2]) : 4;
+        testDistributedTrain("./models/diabetes.init", "./data/diabetes_train.csv", "./data/diabetes_test.csv", numWorkers);
+    } else if (mode == "sweep") {
+        int numThreads = (argc > 2) ? stoi(argv[2]) : thread::hardware_concurrency();
+        testSweep("./data/diabetes_train.csv", "./data/diabetes_test.csv", numThreads);
+    } else if (mode == "cv") {
+        int k = (argc > 2) ? stoi(argv[2]) : 5;
+        bool stratified = (argc > 3) && string(argv[3]) == "stratified";
+        testCrossValidation("./models/diabetes.init", "./data/diabetes_train.csv", k, stratified, thread::hardware_concurrency());
+    } else if (mode == "build") {
+        int numThreads = (argc > 2) ? stoi(argv[2]) : thread::hardware_concurrency();
+        testBuild({2048, 2048, 1024, 1}, numThreads);
+    } else if (mode == "serve") {
+        int numReaders = (argc > 2) ? stoi(argv[2]) : 2;
+        testServe("./models/diabetes.init", "./data/diabetes_train.csv", "./data/diabetes_test.csv", numReaders);
+    } else if (mode == "early") {
+        testEarlyStopping("./models/diabetes.init", "./data/diabetes_train.csv", "./data/diabetes_test.csv");
+    } else if (mode == "mapped") {
+        int numWorkers = (argc > 2) ? stoi(argv[2]) : 4;
+        testMapped("./models/diabetes.init", "./models/diabetes.bin", "./data/diabetes_test.csv", numWorkers);
+    } else if (mode == "optimize") {
+        string outputFile = (argc > 2) ? argv[2] : "./models/diabetes.optimized";
+        testOptimize("./models/diabetes.init", "./data/diabetes_train.csv", "./data/diabetes_test.csv", outputFile);
+    } else if (mode == "explain") {
+        int numInstances = (argc > 2) ? stoi(argv[2]) : 5;
+        testExplain("./models/diabetes.init", "./data/diabetes_train.csv", "./data/diabetes_test.csv", numInstances);
+    } else if (mode == "hogwild") {
+        int maxThreads = (argc > 2) ? stoi(argv[2]) : thread::hardware_concurrency();
+        testHogwild("./models/diabetes.init", "./data/diabetes_train.csv", "./data/diabetes_test.csv", maxThreads);
+    } else if (mode == "ensemble") {
+        int numMembers = (argc > 2) ? stoi(argv[2]) : 5;
+        testEnsemble("./data/diabetes_train.csv", "./data/diabetes_test.csv", numMembers);
+    } else {
+        testTrain("./models/diabetes.init", "./data/diabetes_train.csv", "./data/diabetes_test.csv");
+    }
     return 0;
 }
 
@@ -38,3 +104,405 @@ void testTrain(string networkFile, string trainFile, string testFile) {
     // cout << nn << endl;
     cout << "accuracy: " << nn.assess(testFile) << endl;
 }
+
+
+// trains the same initial network with local worker processes and in this process, then compares the results
+void testDistributedTrain(string networkFile, string trainFile, string testFile, int numWorkers) {
+    NeuralNetwork nn(networkFile);
+    nn.setLearningRate(0.001);
+
+    DataLoader dl(trainFile);
+    vector<DataInstance> data = dl.getData();
+    int numEpochs = 4;
+
+    NeuralNetwork distributed = trainDataParallel(nn, data, numWorkers, numEpochs);
+
+    NeuralNetwork single(nn);
+    single.train();
+    for (int i = 0; i < numEpochs; i++) {
+        for (size_t j = 0; j < data.size(); j++) {
+            single.predict(data.at(j));
+        }
+        single.update();
+    }
+
+    vector<double> a = distributed.getParameters();
+    vector<double> b = single.getParameters();
+    double maxDifference = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        maxDifference = max(maxDifference, fabs(a.at(i) - b.at(i)));
+    }
+
+    DataLoader testDl(testFile);
+    cout << "workers: " << numWorkers << endl;
+    cout << "max parameter difference: " << maxDifference << endl;
+    cout << "distributed accuracy: " << distributed.assess(testDl) << endl;
+    cout << "single process accuracy: " << single.assess(testDl) << endl;
+
+    // only the order of the gradient sums differs from single process training
+    if (maxDifference > 1e-9) {
+        cerr << "Data parallel training diverged from single process training" << endl;
+        exit(1);
+    }
+}
+
+// searches learning rates and hidden layer widths with successive halving
+void testSweep(string trainFile, string testFile, int numThreads) {
+    DataLoader trainDl(trainFile);
+    DataLoader testDl(testFile);
+
+    // configurations are compared on data held out of the training set, the test set is only used at the end
+    vector<DataInstance> train, validation;
+    holdOut(trainDl.getData(), 5, train, validation);
+
+    vector<double> learningRates = {0.0001, 0.0005, 0.001, 0.005, 0.01};
+    vector<vector<int> > shapes = {{3}, {5}, {8}, {3, 5}, {8, 4}};
+    vector<SweepConfig> configs;
+    for (int i = 0; i < learningRates.size(); i++) {
+        for (int j = 0; j < shapes.size(); j++) {
+            configs.push_back(SweepConfig(learningRates.at(i), shapes.at(j)));
+        }
+    }
+
+    Sweep sweep(train, validation, numThreads);
+    vector<SweepResult> results = sweep.run(configs, 1, 27, 3);
+    Sweep::writeResults(results, "./sweep_results.csv");
+
+    NeuralNetwork best = sweep.retrain(results.at(0));
+    cout << "configurations: " << configs.size() << endl;
+    cout << "best: " << results.at(0).config.describe() << " learning rate: " << results.at(0).config.learningRate
+         << " epochs: " << results.at(0).epochs << " validation accuracy: " << results.at(0).accuracy
+         << " test accuracy: " << best.assess(testDl) << endl;
+}
+
+// k-fold cross validation of the initial network over one load of the data
+void testCrossValidation(string networkFile, string dataFile, int k, bool stratified, int numThreads) {
+    NeuralNetwork nn(networkFile);
+    nn.setLearningRate(0.001);
+
+    // folds normalize with their own training statistics, so load the raw features
+    DataLoader dl(dataFile, false);
+    vector<Fold> folds = stratified ? stratifiedKFold(dl.getData(), k) : kFold(dl.getData(), k);
+
+    ThreadPool pool(numThreads);
+    CrossValidationResult result = crossValidate(nn, folds, 4, pool);
+
+    for (int i = 0; i < result.foldAccuracies.size(); i++) {
+        cout << "fold: " << i << " accuracy: " << result.foldAccuracies.at(i) << endl;
+    }
+    cout << "mean accuracy: " << result.mean << " std: " << result.stdDev << endl;
+}
+
+// times bulk construction of a large network and checks it does not depend on the thread count
+void testBuild(vector<int> layerSizes, int numThreads) {
+    NetworkBuilder builder;
+    builder.addLayer(layerSizes.front(), "identity");
+    for (int i = 1; i < layerSizes.size(); i++) {
+        builder.addLayer(layerSizes.at(i), "ReLU");
+    }
+    builder.setWeightInit(WeightInit::He).setSeed(42);
+
+    ThreadPool pool(numThreads);
+    auto start = chrono::steady_clock::now();
+    NeuralNetwork parallel = builder.build(pool);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    NeuralNetwork serial = builder.build();
+    bool identical = parallel.getParameters() == serial.getParameters();
+
+    cout << "threads: " << numThreads << " build time: " << seconds << "s" << endl;
+    cout << "parameters: " << parallel.getParameters().size() << " identical to serial build: " << (identical ? "yes" : "no") << endl;
+}
+
+// scores the test set from several threads while the model keeps training and publishing new versions
+void testServe(string networkFile, string trainFile, string testFile, int numReaders) {
+    NeuralNetwork nn(networkFile);
+    nn.setLearningRate(0.001);
+    DataLoader trainDl(trainFile);
+    DataLoader testDl(testFile);
+
+    ModelHandle handle(nn);
+    atomic<bool> training(true);
+
+    vector<thread> readers;
+    vector<vector<double> > latencies(numReaders);
+    vector<unsigned long> versionsSeen(numReaders, 0);
+    for (int r = 0; r < numReaders; r++) {
+        readers.push_back(thread([&, r]() {
+            const vector<DataInstance>& data = testDl.getData();
+            for (size_t j = 0; training.load() || j < data.size(); j++) {
+                auto start = chrono::steady_clock::now();
+                ModelHandle::Reader reader(handle);
+                reader.get().model.predict(data[j % data.size()]);
+                latencies[r].push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+                versionsSeen[r] = max(versionsSeen[r], reader.get().version);
+            }
+        }));
+    }
+
+    nn.train();
+    int numEpochs = 20;
+    for (int i = 0; i < numEpochs; i++) {
+        for (size_t j = 0; j < trainDl.getData().size(); j++) {
+            nn.predict(trainDl.getData().at(j));
+        }
+        nn.update();
+        handle.publish(nn);
+    }
+    training.store(false);
+
+    for (int r = 0; r < numReaders; r++) {
+        readers[r].join();
+        sort(latencies[r].begin(), latencies[r].end());
+        cout << "reader: " << r << " predictions: " << latencies[r].size()
+             << " median latency: " << latencies[r][latencies[r].size() / 2] << "us"
+             << " p99 latency: " << latencies[r][latencies[r].size() * 99 / 100] << "us"
+             << " newest version: " << versionsSeen[r] << endl;
+    }
+    cout << "published version: " << handle.getVersion() << " accuracy: " << nn.assess(testDl) << endl;
+}
+
+// trains until the validation accuracy stops improving
+void testEarlyStopping(string networkFile, string trainFile, string testFile) {
+    NeuralNetwork nn(networkFile);
+    nn.setLearningRate(0.001);
+
+    DataLoader trainDl(trainFile);
+    DataLoader testDl(testFile);
+
+    // the stopping epoch is chosen on data held out of the training set, the test set is only used at the end
+    vector<DataInstance> train, validation;
+    holdOut(trainDl.getData(), 5, train, validation);
+
+    TrainingHistory history = trainWithEarlyStopping(nn, train, validation, EarlyStoppingConfig());
+
+    for (int i = 0; i < history.epochs; i++) {
+        cout << "epoch: " << i << " subsample accuracy: " << history.subsampleAccuracies.at(i)
+             << " learning rate: " << history.learningRates.at(i) << endl;
+    }
+    cout << "epochs: " << history.epochs << " full evaluations: " << history.fullEvaluations << endl;
+    cout << "best epoch: " << history.bestEpoch << " validation accuracy: " << history.bestAccuracy
+         << " test accuracy: " << nn.assess(testDl) << endl;
+}
+
+// exports a binary model and scores it from several worker processes that all map the same file
+void testMapped(string networkFile, string binaryFile, string testFile, int numWorkers) {
+    NeuralNetwork nn(networkFile);
+    saveBinaryModel(nn, binaryFile);
+
+    DataLoader dl(testFile);
+    cout << "graph accuracy: " << nn.assess(dl) << endl;
+    cout.flush();
+
+    // fork every worker before waiting for any, so they all map the file at the same time
+    vector<pid_t> workers;
+    for (int w = 0; w < numWorkers; w++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            cerr << "Could not fork worker " << w << ": " << strerror(errno) << endl;
+            break;
+        }
+
+        if (pid == 0) {
+            auto start = chrono::steady_clock::now();
+            MappedModel model(binaryFile);
+            double seconds = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+
+            double correct = 0;
+            for (size_t j = 0; j < dl.getData().size(); j++) {
+                if (static_cast<int>(round(model.predict(dl.getData()[j]).at(0))) == dl.getData()[j].y) {
+                    correct++;
+                }
+            }
+
+            // one write per line, so lines of concurrent workers do not interleave
+            ostringstream line;
+            line << "worker: " << w << " pid: " << getpid() << " load time: " << seconds << "us accuracy: " << correct / dl.getData().size() << endl;
+            write(STDOUT_FILENO, line.str().data(), line.str().size());
+            _exit(0);
+        }
+        workers.push_back(pid);
+    }
+
+    bool failed = workers.size() < numWorkers;
+    for (int w = 0; w < workers.size(); w++) {
+        int status = 0;
+        waitpid(workers[w], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            cerr << "Worker " << w << " failed" << endl;
+            failed = true;
+        }
+    }
+    if (failed) {
+        exit(1);
+    }
+}
+
+// trains a network, folds the training normalization into it and checks the optimized model on raw features
+void testOptimize(string networkFile, string trainFile, string testFile, string outputFile) {
+    NeuralNetwork nn(networkFile);
+    nn.setLearningRate(0.001);
+
+    DataLoader dl(trainFile);
+    nn.train();
+    for (int i = 0; i < 4; i++) {
+        for (size_t j = 0; j < dl.getData().size(); j++) {
+            nn.predict(dl.getData().at(j));
+        }
+        nn.update();
+    }
+
+    // the statistics the training data was normalized with
+    DataLoader rawTrain(trainFile, false);
+    vector<double> mean = calculateMean(rawTrain.getData());
+    vector<double> stdDev = calculateStdDev(rawTrain.getData(), mean);
+
+    OptimizationReport report;
+    NeuralNetwork optimized = optimizeNetwork(nn, mean, stdDev, report);
+    optimized.saveModel(outputFile);
+    NeuralNetwork loaded(outputFile);
+
+    // score the original on normalized test features and the optimized model on raw ones
+    DataLoader rawTest(testFile, false);
+    vector<DataInstance> normalizedTest = rawTest.getData();
+    for (size_t j = 0; j < normalizedTest.size(); j++) {
+        for (size_t i = 0; i < mean.size(); i++) {
+            normalizedTest[j].x[i] = (normalizedTest[j].x[i] - mean[i]) / stdDev[i];
+        }
+    }
+
+    nn.eval();
+    loaded.eval();
+    double maxDifference = 0;
+    for (size_t j = 0; j < normalizedTest.size(); j++) {
+        maxDifference = max(maxDifference, fabs(nn.predict(normalizedTest[j]).at(0) - loaded.predict(rawTest.getData()[j]).at(0)));
+    }
+
+    cout << "nodes: " << report.nodesBefore << " -> " << report.nodesAfter
+         << " weights: " << report.weightsBefore << " -> " << report.weightsAfter
+         << " layers collapsed: " << report.layersCollapsed << " dead nodes removed: " << report.deadNodesRemoved << endl;
+    cout << "original accuracy: " << nn.assess(normalizedTest) << " optimized accuracy: " << loaded.assess(rawTest) << endl;
+    cout << "max prediction difference: " << maxDifference << endl;
+
+    if (maxDifference > 1e-12) {
+        cerr << "The optimized model does not match the original" << endl;
+        exit(1);
+    }
+}
+
+// prints per-feature attributions, d(prediction) / d(feature), for the first test instances
+void testExplain(string networkFile, string trainFile, string testFile, int numInstances) {
+    NeuralNetwork nn(networkFile);
+    nn.setLearningRate(0.001);
+
+    DataLoader dl(trainFile);
+    nn.train();
+    for (int i = 0; i < 4; i++) {
+        for (size_t j = 0; j < dl.getData().size(); j++) {
+            nn.predict(dl.getData().at(j));
+        }
+        nn.update();
+    }
+
+    DataLoader testDl(testFile);
+    int batchLength = min<int>(numInstances, testDl.getData().size());
+    vector<DataInstance> batch(testDl.getData().begin(), testDl.getData().begin() + batchLength);
+    vector<vector<double> > gradients = nn.inputGradients(batch);
+
+    nn.eval();
+    for (int b = 0; b < batchLength; b++) {
+        cout << "instance: " << b << " prediction: " << nn.predict(batch.at(b)).at(0) << " attributions: " << gradients.at(b) << endl;
+    }
+}
+
+// compares synchronous minibatch training with asynchronous Hogwild training for 1, 2, 4, ... threads
+void testHogwild(string networkFile, string trainFile, string testFile, int maxThreads) {
+    NeuralNetwork nn(networkFile);
+    nn.setLearningRate(0.01);
+
+    DataLoader trainDl(trainFile);
+    DataLoader testDl(testFile);
+    int numEpochs = 10;
+    int batchSize = 64;
+
+    for (int numThreads = 1; numThreads <= max(1, maxThreads); numThreads *= 2) {
+        ThreadPool pool(numThreads);
+
+        HogwildTrainer sync(nn);
+        TrainingStats syncStats = sync.trainSync(trainDl.getData(), numEpochs, batchSize, pool, testDl.getData());
+
+        HogwildTrainer async(nn);
+        TrainingStats asyncStats = async.trainAsync(trainDl.getData(), numEpochs, pool, testDl.getData());
+
+        cout << "threads: " << numThreads << " learning rate: " << nn.getLearningRate()
+             << " sync (mean gradient of " << batchSize << "): " << syncStats.samplesPerSecond << " samples/s accuracy: " << syncStats.accuracy
+             << " async (per instance): " << asyncStats.samplesPerSecond << " samples/s accuracy: " << asyncStats.accuracy << endl;
+    }
+}
+
+// trains members from different seeds and compares fused ensemble inference with calling predict on every member
+void testEnsemble(string trainFile, string testFile, int numMembers) {
+    DataLoader trainDl(trainFile);
+    DataLoader testDl(testFile);
+    const vector<DataInstance>& test = testDl.getData();
+
+    vector<NeuralNetwork> members;
+    for (int m = 0; m < numMembers; m++) {
+        NetworkBuilder builder;
+        builder.addLayer(8, "identity").addLayer(3, "sigmoid").addLayer(5, "sigmoid").addLayer(1, "sigmoid");
+        builder.setWeightInit(WeightInit::Xavier).setSeed(m + 1);
+        members.push_back(builder.build());
+        members.back().setLearningRate(0.001);
+
+        members.back().train();
+        for (int i = 0; i < 4; i++) {
+            for (size_t j = 0; j < trainDl.getData().size(); j++) {
+                members.back().predict(trainDl.getData().at(j));
+            }
+            members.back().update();
+        }
+        members.back().eval();
+    }
+
+    vector<const NeuralNetwork*> pointers;
+    for (int m = 0; m < numMembers; m++) {
+        pointers.push_back(&members.at(m));
+    }
+    Ensemble ensemble(pointers);
+
+    auto start = chrono::steady_clock::now();
+    vector<double> separate(test.size(), 0);
+    for (int m = 0; m < numMembers; m++) {
+        for (size_t j = 0; j < test.size(); j++) {
+            separate[j] += members[m].predict(test[j]).at(0) / numMembers;
+        }
+    }
+    double separateSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    vector<double> fused = ensemble.predict(test, EnsembleCombine::Mean);
+    double fusedSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    double maxDifference = 0;
+    for (size_t j = 0; j < test.size(); j++) {
+        maxDifference = max(maxDifference, fabs(separate[j] - fused[j]));
+    }
+
+    cout << "members: " << numMembers << " separate: " << separateSeconds << "s fused: " << fusedSeconds << "s" << endl;
+    cout << "mean accuracy: " << ensemble.assess(test, EnsembleCombine::Mean)
+         << " vote accuracy: " << ensemble.assess(test, EnsembleCombine::Vote) << endl;
+    cout << "max prediction difference: " << maxDifference << endl;
+}
+
+// splits data into k shuffled folds and holds the first one out for validation
+void holdOut(const vector<DataInstance>& data, int k, vector<DataInstance>& train, vector<DataInstance>& validation) {
+    Fold fold = kFold(data, k).front();
+    train.clear();
+    validation.clear();
+    for (size_t i = 0; i < fold.train.size(); i++) {
+        train.push_back(fold.train.at(i));
+    }
+    for (size_t i = 0; i < fold.test.size(); i++) {
+        validation.push_back(fold.test.at(i));
+    }
+}
@@ -0,0 +1,32 @@
+#include <iostream>
+#include "NeuralNetwork.hpp"
+#include "DataLoader.hpp"
+#include "diabetes_scorer.hpp"
+using namespace std;
+
+// checks that the header codegen emitted for models/diabetes.init scores every test row
+// exactly like NeuralNetwork::predict
+int main() {
+    NeuralNetwork nn("./models/diabetes.init");
+    nn.eval();
+    DataLoader dl("./data/diabetes_test.csv");
+
+    int mismatches = 0;
+    for (size_t j = 0; j < dl.getData().size(); j++) {
+        const DataInstance& instance = dl.getData()[j];
+        array<double, 8> x;
+        copy(instance.x.begin(), instance.x.end(), x.begin());
+
+        double expected = nn.predict(instance).at(0);
+        double actual = diabetes::Model<8, 3, 5, 1>::predict(x)[0];
+        if (actual != expected) {
+            if (mismatches == 0) {
+                cerr << "row " << j << ": predict " << expected << " but generated scorer " << actual << endl;
+            }
+            mismatches++;
+        }
+    }
+
+    cout << "codegen: " << mismatches << " mismatches out of " << dl.getData().size() << endl;
+    return (mismatches == 0) ? 0 : 1;
+}
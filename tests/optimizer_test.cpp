@@ -0,0 +1,78 @@
+#include <iostream>
+#include "GraphOptimizer.hpp"
+#include "NetworkBuilder.hpp"
+using namespace std;
+
+static bool check(bool condition, string description) {
+    cout << description << ": " << (condition ? "ok" : "FAILED") << endl;
+    return condition;
+}
+
+// largest difference between the original on normalized features and the optimized network on raw ones
+static double maxDifference(NeuralNetwork& original, NeuralNetwork& optimized, const vector<DataInstance>& raw,
+                            const vector<double>& mean, const vector<double>& stdDev) {
+    original.eval();
+    optimized.eval();
+    double difference = 0;
+    for (size_t j = 0; j < raw.size(); j++) {
+        DataInstance normalized = raw[j];
+        for (size_t i = 0; i < mean.size(); i++) {
+            normalized.x[i] = (raw[j].x[i] - mean[i]) / stdDev[i];
+        }
+        difference = max(difference, fabs(original.predict(normalized).at(0) - optimized.predict(raw[j]).at(0)));
+    }
+    return difference;
+}
+
+// checks that optimizeNetwork keeps predictions while folding normalization, collapsing an
+// identity hidden layer and removing a dead and a constant hidden node
+int main() {
+    const double tolerance = 1e-12;
+    bool passed = true;
+
+    DataLoader raw("./data/diabetes_test.csv", false);
+    vector<double> mean = calculateMean(raw.getData());
+    vector<double> stdDev = calculateStdDev(raw.getData(), mean);
+
+    // the shipped model only has the normalization to fold
+    NeuralNetwork diabetes("./models/diabetes.init");
+    OptimizationReport diabetesReport;
+    NeuralNetwork diabetesOptimized = optimizeNetwork(diabetes, mean, stdDev, diabetesReport);
+    double difference = maxDifference(diabetes, diabetesOptimized, raw.getData(), mean, stdDev);
+    cout << "diabetes.init max prediction difference: " << difference << endl;
+    passed = check(difference <= tolerance, "normalization folds into models/diabetes.init") && passed;
+
+    // 8-16(identity)-4-3-1: the identity layer collapses into the next one, node 1 of the
+    // 3-node layer reaches no output and node 2 does not depend on the inputs
+    NetworkBuilder builder;
+    builder.addLayer(8, "identity").addLayer(16, "identity").addLayer(4, "sigmoid").addLayer(3, "ReLU").addLayer(1, "sigmoid");
+    builder.setWeightInit(WeightInit::Xavier);
+    NeuralNetwork nn = builder.build();
+    vector<vector<int> > layers = nn.getLayers();
+    for (int k = 0; k < layers[4].size(); k++) {
+        nn.updateConnection(layers[3][1], layers[4][k], 0);
+    }
+    for (int i = 0; i < layers[2].size(); i++) {
+        nn.updateConnection(layers[2][i], layers[3][2], 0);
+    }
+    for (int l = 0; l < layers.size(); l++) {
+        for (int j = 0; j < layers[l].size(); j++) {
+            nn.getNode(layers[l][j])->bias = 0.1 * (layers[l][j] % 5);
+        }
+    }
+
+    OptimizationReport report;
+    NeuralNetwork optimized = optimizeNetwork(nn, mean, stdDev, report);
+    cout << "nodes: " << report.nodesBefore << " -> " << report.nodesAfter
+         << " weights: " << report.weightsBefore << " -> " << report.weightsAfter << endl;
+    passed = check(report.layersCollapsed == 1, "the identity hidden layer collapses") && passed;
+    passed = check(report.deadNodesRemoved == 2, "the dead and the constant node are removed") && passed;
+    passed = check(report.nodesBefore == 32 && report.nodesAfter == 14 && report.weightsBefore == 207 && report.weightsAfter == 37,
+                   "32 nodes / 207 weights shrink to 14 / 37") && passed;
+
+    difference = maxDifference(nn, optimized, raw.getData(), mean, stdDev);
+    cout << "synthetic max prediction difference: " << difference << endl;
+    passed = check(difference <= tolerance, "the optimized synthetic network predicts the same") && passed;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,55 @@
+#include <iostream>
+#include "NeuralNetwork.hpp"
+#include "DataLoader.hpp"
+using namespace std;
+
+// checks NeuralNetwork::inputGradients against central finite differences of predict on
+// models/diabetes.init after a few epochs of training, and that it leaves the network untouched
+int main() {
+    const double h = 1e-6;
+    const double tolerance = 1e-8;
+    bool passed = true;
+
+    NeuralNetwork nn("./models/diabetes.init");
+    nn.setLearningRate(0.001);
+    DataLoader trainDl("./data/diabetes_train.csv");
+    nn.train();
+    for (int epoch = 0; epoch < 4; epoch++) {
+        for (size_t j = 0; j < trainDl.getData().size(); j++) {
+            nn.predict(trainDl.getData()[j]);
+        }
+        nn.update();
+    }
+
+    // accumulate some gradients first, inputGradients must not disturb them
+    for (size_t j = 0; j < 10; j++) {
+        nn.predict(trainDl.getData()[j]);
+    }
+    vector<double> parameters = nn.getParameters();
+    vector<double> gradients = nn.getGradients();
+
+    DataLoader testDl("./data/diabetes_test.csv");
+    vector<DataInstance> batch(testDl.getData().begin(), testDl.getData().begin() + 200);
+    vector<vector<double> > saliency = nn.inputGradients(batch);
+
+    bool untouched = nn.getParameters() == parameters && nn.getGradients() == gradients;
+    cout << "parameters and accumulated gradients unchanged: " << (untouched ? "ok" : "FAILED") << endl;
+    passed = passed && untouched;
+
+    nn.eval();
+    double maxDifference = 0;
+    for (size_t b = 0; b < batch.size(); b++) {
+        for (size_t i = 0; i < batch[b].x.size(); i++) {
+            DataInstance plus = batch[b];
+            DataInstance minus = batch[b];
+            plus.x[i] += h;
+            minus.x[i] -= h;
+            double finiteDifference = (nn.predict(plus).at(0) - nn.predict(minus).at(0)) / (2 * h);
+            maxDifference = max(maxDifference, fabs(finiteDifference - saliency[b][i]));
+        }
+    }
+    cout << "max difference from finite differences: " << maxDifference << endl;
+    passed = passed && maxDifference < tolerance;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "NeuralNetwork.hpp"
+#include "DataLoader.hpp"
+using namespace std;
+
+static bool check(bool condition, string description) {
+    cout << description << ": " << (condition ? "ok" : "FAILED") << endl;
+    return condition;
+}
+
+// writes data as libsvm lines, listing only the non-zero features from index 1
+static string toLibsvm(const vector<DataInstance>& data) {
+    ostringstream out;
+    out.precision(numeric_limits<double>::max_digits10);
+    for (size_t j = 0; j < data.size(); j++) {
+        out << data[j].y;
+        for (size_t i = 0; i < data[j].x.size(); i++) {
+            if (data[j].x[i] != 0) {
+                out << " " << i + 1 << ":" << data[j].x[i];
+            }
+        }
+        out << "\n";
+    }
+    return out.str();
+}
+
+// whether loading text exits with a non-zero status
+static bool loadFails(string text) {
+    cout.flush();
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(STDERR_FILENO);
+        istringstream in(text);
+        DataLoader dl(in);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+}
+
+// checks sparse libsvm loading and that training on it matches training on the same dense data
+int main() {
+    bool passed = true;
+
+    // the same raw features, dense and as libsvm; sparse files are never normalized
+    DataLoader dense("./data/diabetes_train.csv", false);
+    istringstream libsvm(toLibsvm(dense.getData()));
+    DataLoader sparse(libsvm);
+    passed = check(sparse.isSparse() && sparse.getData().size() == dense.getData().size(), "libsvm copy of the training data loads as sparse") && passed;
+
+    NeuralNetwork denseNet("./models/diabetes.init");
+    NeuralNetwork sparseNet(denseNet);
+    denseNet.setLearningRate(0.001);
+    sparseNet.setLearningRate(0.001);
+    denseNet.train();
+    sparseNet.train();
+    for (int epoch = 0; epoch < 3; epoch++) {
+        for (size_t j = 0; j < dense.getData().size(); j++) {
+            denseNet.predict(dense.getData()[j]);
+            sparseNet.predict(sparse.getData()[j]);
+        }
+        denseNet.update();
+        sparseNet.update();
+    }
+
+    vector<double> a = denseNet.getParameters();
+    vector<double> b = sparseNet.getParameters();
+    double maxDifference = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        maxDifference = max(maxDifference, fabs(a[i] - b[i]));
+    }
+    cout << "max parameter difference after 3 epochs: " << maxDifference << endl;
+    passed = check(maxDifference == 0, "sparse training matches dense training") && passed;
+
+    // libsvm numbers features from 1
+    istringstream oneBased("1 1:0.5 8:1.0\n");
+    DataLoader oneBasedDl(oneBased);
+    const DataInstance& instance = oneBasedDl.getData().at(0);
+    passed = check(instance.sparse && instance.indices == vector<int>({0, 7}) && instance.y == 1, "indices 1 and 8 load as features 0 and 7") && passed;
+    passed = check(loadFails("1 0:0.5\n"), "index 0 is rejected") && passed;
+
+    NeuralNetwork nn("./models/diabetes.init");
+    nn.eval();
+    istringstream outOfRange("1 9:1.0\n");
+    DataLoader outOfRangeDl(outOfRange);
+    cerr.setstate(ios::failbit);
+    bool rejected = nn.predict(outOfRangeDl.getData().at(0)).empty();
+    cerr.clear();
+    passed = check(rejected, "index 9 of 8 features is rejected by predict") && passed;
+
+    // a label-only line is an all-zero sparse instance, wherever it appears in the file
+    istringstream labelOnly("1\n0 3:1.5\n");
+    DataLoader labelOnlyDl(labelOnly);
+    const vector<DataInstance>& rows = labelOnlyDl.getData();
+    passed = check(rows.size() == 2 && rows[0].sparse && rows[0].indices.empty() && rows[1].sparse, "a label-only line loads as an empty sparse instance") && passed;
+    passed = check(nn.predict(rows[0]).size() == 1 && nn.predict(rows[1]).size() == 1, "predict scores the label-only instance") && passed;
+
+    return passed ? 0 : 1;
+}
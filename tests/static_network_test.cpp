@@ -0,0 +1,71 @@
+#include <iostream>
+#include "NeuralNetwork.hpp"
+#include "DataLoader.hpp"
+#include "StaticNetwork.hpp"
+using namespace std;
+
+typedef StaticNetwork<Layer<8, Activation::Identity>, Layer<3>, Layer<5>, Layer<1> > DiabetesNetwork;
+
+// largest difference between the first outputs of nn and sn over data
+static double maxDifference(NeuralNetwork& nn, DiabetesNetwork& sn, const vector<DataInstance>& data) {
+    double difference = 0;
+    for (size_t j = 0; j < data.size(); j++) {
+        array<double, 8> x;
+        copy(data[j].x.begin(), data[j].x.end(), x.begin());
+        difference = max(difference, fabs(nn.predict(data[j]).at(0) - sn.forward(x)[0]));
+    }
+    return difference;
+}
+
+// checks StaticNetwork against NeuralNetwork on models/diabetes.init: a round trip through
+// toNeuralNetwork, forward parity, and parity after a few epochs of training
+int main() {
+    const double tolerance = 1e-12;
+    bool passed = true;
+
+    NeuralNetwork nn("./models/diabetes.init");
+    nn.setLearningRate(0.001);
+    DiabetesNetwork sn = DiabetesNetwork::fromNeuralNetwork(nn);
+
+    NeuralNetwork roundTrip = sn.toNeuralNetwork();
+    DiabetesNetwork again = DiabetesNetwork::fromNeuralNetwork(roundTrip);
+    for (int l = 0; l < DiabetesNetwork::numLayers; l++) {
+        for (int j = 0; j < DiabetesNetwork::sizes[l]; j++) {
+            passed = passed && again.bias(l, j) == sn.bias(l, j);
+            for (int i = 0; l > 0 && i < DiabetesNetwork::sizes[l-1]; i++) {
+                passed = passed && again.weight(l, j, i) == sn.weight(l, j, i);
+            }
+        }
+    }
+    cout << "round trip: " << (passed ? "identical" : "differs") << endl;
+
+    DataLoader trainDl("./data/diabetes_train.csv");
+    DataLoader testDl("./data/diabetes_test.csv");
+
+    nn.eval();
+    double forward = maxDifference(nn, sn, testDl.getData());
+    cout << "forward max difference: " << forward << endl;
+    passed = passed && forward < tolerance;
+
+    nn.train();
+    for (int epoch = 0; epoch < 4; epoch++) {
+        for (size_t j = 0; j < trainDl.getData().size(); j++) {
+            const DataInstance& instance = trainDl.getData()[j];
+            array<double, 8> x;
+            copy(instance.x.begin(), instance.x.end(), x.begin());
+
+            nn.predict(instance);
+            sn.forward(x);
+            sn.backward(instance.y);
+        }
+        nn.update();
+        sn.update();
+    }
+
+    nn.eval();
+    double trained = maxDifference(nn, sn, testDl.getData());
+    cout << "trained max difference: " << trained << endl;
+    passed = passed && trained < tolerance;
+
+    return passed ? 0 : 1;
+}
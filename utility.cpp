@@ -68,6 +68,32 @@ double sample() {
     return dist(gen);
 }
 
+std::array<uint32_t, 4> philox(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key) {
+    const uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+    const uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+
+    for (int round = 0; round < 10; round++) {
+        uint64_t p0 = static_cast<uint64_t>(M0) * counter[0];
+        uint64_t p1 = static_cast<uint64_t>(M1) * counter[2];
+        counter = {static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(p1),
+                   static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(p0)};
+        key[0] += W0;
+        key[1] += W1;
+    }
+    return counter;
+}
+
+double sample(uint64_t seed, uint32_t stream, uint64_t index) {
+    std::array<uint32_t, 4> r = philox({static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32), stream, 0},
+                                       {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)});
+
+    // two uniforms in (0, 1) with 53 random bits each, then Box-Muller
+    const double scale = 1.0 / 9007199254740992.0;
+    double u1 = ((((static_cast<uint64_t>(r[0]) << 32) | r[1]) >> 11) + 0.5) * scale;
+    double u2 = ((((static_cast<uint64_t>(r[2]) << 32) | r[3]) >> 11) + 0.5) * scale;
+    return std::sqrt(-2 * std::log(u1)) * std::cos(2 * M_PI * u2);
+}
+
 std::ostream& operator<<(std::ostream& out, std::vector<double> v) {
     for (int i = 0; i < v.size(); i++) {
         out << v.at(i) << " ";
@@ -5,6 +5,8 @@
 #include <string>
 #include <random>
 #include <iostream>
+#include <array>
+#include <cstdint>
 typedef double(* FuncSig)(double param);
 
 // Activation functions
@@ -23,6 +25,12 @@ std::string getActivationIdentifier(FuncSig f);
 
 double sample();
 
+// Philox4x32-10 counter-based generator: the output depends only on (counter, key),
+// so any value of a stream can be computed independently of all others
+std::array<uint32_t, 4> philox(std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key);
+// standard normal sample number index of the given stream, keyed by seed
+double sample(uint64_t seed, uint32_t stream, uint64_t index);
+
 std::ostream& operator<<(std::ostream& out, std::vector<double> v);
 
 #endif
\ No newline at end of file